@@ -2,21 +2,23 @@
 #define SIGNALSELECTIONDIALOG_H
 
 #include <QDialog>
-#include <QTreeWidget>
+#include <QTreeView>
 #include <QPushButton>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QDialogButtonBox>
 #include <QLineEdit>
 #include <QLabel>
-#include <QProgressBar>
+#include <QComboBox>
 #include <QMap>
 #include <QSet>
 #include <QTimer>
-#include <QFuture>
-#include <QFutureWatcher>
-#include <QtConcurrent>
+#include <QBitArray>
 #include "vcdparser.h"
+#include "signaltreemodel.h"
+#include "signalpatternsearch.h"
+#include <QElapsedTimer>
+#include <functional>
 
 class MainWindow; // Forward declaration
 
@@ -27,27 +29,24 @@ public:
     explicit SignalSelectionDialog(QWidget *parent = nullptr);
     ~SignalSelectionDialog();
 
-    void setAvailableSignals(const QVector<VCDSignal> &allSignals, const QList<VCDSignal> &visibleSignals);
+    void setAvailableSignals(VCDParser *parser, const QList<VCDSignal> &visibleSignals);
     QList<VCDSignal> getSelectedSignals() const;
 
     // NEW: RTL processing setup
-    void setRtlProcessingInfo(MainWindow *mainWindow, const QString &vcdFilePath, bool &rtlProcessed, QString &tempVcdPath);
+    void setRtlProcessingInfo(MainWindow *mainWindow, const QString &vcdFilePath, bool &rtlProcessed);
 
 protected:
     void closeEvent(QCloseEvent *event) override;
     void showEvent(QShowEvent *event) override;
 
 private slots:
-    void onScopeItemChanged(QTreeWidgetItem *item, int column);
     void selectAll();
     void deselectAll();
     void onSearchTextChanged(const QString &text);
-    void onItemExpanded(QTreeWidgetItem *item);
-    void onItemChanged(QTreeWidgetItem *item, int column);
-    void onItemClicked(QTreeWidgetItem *item, int column);
+    void onItemClicked(const QModelIndex &index);
     void onSearchTimerTimeout();
-    void onLoadProgress(int percentage);
-    void onLoadFinished();
+    void onPatternSearchProgress(const QBitArray &matches, int shardsDone, int shardsTotal);
+    void onPatternSearchFinished(const QBitArray &matches);
 
     // NEW: Filter button slots
     void onFilterInputPorts();
@@ -56,6 +55,7 @@ private slots:
     void onFilterNetSignals();
     void onFilterRegisters();
     void onFilterAll();
+    void onWidthFilterChanged(int bucket);
 
     void onRtlDirectoryButtonClicked(); // ADD THIS
 
@@ -66,82 +66,70 @@ private:
     QPushButton *filterNetButton;
     QPushButton *filterRegButton;
     QPushButton *filterAllButton;
+    QComboBox *widthFilterCombo;
 
     QPushButton *rtlDirectoryButton; // ADD THIS LINE
-    void processNextChunk();
-    void populateTopLevelScopes();
     void performSearch(const QString &text);
-    void populateScopeChildren(const QString &scopePath, QTreeWidgetItem *parentItem);
-    void displaySearchResults(const QString &text, int matches, const QMap<QString, QVector<VCDSignal>> &matchingSignalsByScope);
     void onSearchFinished();
     void applySignalFilter();
+    void buildCategoryMasks();
+    QBitArray typeMask();
+    void showFilteredTree(const QBitArray &mask);
 
-    // NEW: Method to check and process RTL for port filters
-    bool ensureRtlProcessedForPortFilter(const QString &filterType);
+    // NEW: Method to check and process RTL for port filters. The RTL scan
+    // runs in the background, so the answer comes through done(ok); it is
+    // never called once the dialog is gone.
+    void ensureRtlProcessedForPortFilter(const QString &filterType, std::function<void(bool)> done);
+    void askForRtlDirectory(std::function<void(bool)> done);
+    void setRtlScanInProgress(bool running);
 
     // UI Components
-    QTreeWidget *signalTree;
+    QTreeView *signalTree;
+    SignalTreeModel *signalModel;
     QPushButton *selectAllButton;
     QPushButton *deselectAllButton;
     QDialogButtonBox *buttonBox;
     QLineEdit *searchEdit;
-    QProgressBar *progressBar;
     QLabel *statusLabel;
 
     // Loading and search management
     QTimer *searchTimer;
     QString pendingSearchText;
     bool isSearchInProgress;
-    bool isLoadingInProgress;
-    bool isInitialLoadComplete;
 
-    // Loading state variables
-    int currentLoadIndex;
-    int totalSignalsToProcess;
+    // Signals not already in the waveform, empty when that is all of them;
+    // every filter is ANDed with it
+    QBitArray availableMask;
+    QBitArray searchMask; // Empty when no search text
 
-    // Data storage with caching
-    QVector<VCDSignal> allSignals;
-    QSet<QString> visibleSignalIdentifiers;
-    QSet<QString> selectedSignals;
-
-    // Scope structure with loading state
-    QMap<QString, QVector<VCDSignal>> scopeSignals;
-    QMap<QString, QStringList> childScopes;
-    QSet<QString> populatedScopes;
-    QSet<QString> loadingScopes; // Scopes currently being loaded
+    // NEW: Glob/regex searches run on the thread pool
+    SignalPatternSearch *patternSearch;
+    QElapsedTimer patternRefreshTimer;
 
     // Multi-selection support
-    QTreeWidgetItem *lastSelectedItem;
+    QPersistentModelIndex lastSelectedIndex;
     QString currentFilter;
 
     // NEW: Signal type filter
     QString currentTypeFilter;
 
-    // Async loading
-    QFutureWatcher<void> *loadWatcher;
-    QFuture<void> loadFuture;
+    // Category bitmaps, built once per parser (and again after RTL processing)
+    // so a filter click is a few ANDs instead of a header rescan
+    QHash<QString, QBitArray> typeMasks; // Lower-case type or port direction
+    QVector<QBitArray> widthMasks;       // Per width bucket, empty for "any"
+    bool typeMasksHaveDirections;        // Built with RTL port directions
+    bool categoryMasksValid;
 
     // NEW: RTL processing members
     MainWindow *mainWindow;
     QString currentVcdFilePath;
     bool *rtlProcessed;
-    QString *tempVcdFilePath;
 
     // NEW: Store the VCD parser reference
     VCDParser *vcdParser;
 
     // Methods
-    void startInitialLoad();
-    void performInitialLoad();
-    void buildScopeStructure();
-    void populateTopLevelScopesLazy();
-    void buildScopeStructureChunked();
-    void populateScopeChildrenLazy(const QString &scopePath, QTreeWidgetItem *parentItem);
-    void updateScopeCheckState(QTreeWidgetItem *scopeItem);
-    void updateParentScopeCheckState(QTreeWidgetItem *childItem);
-    void setScopeSignalsSelection(const QString &scopePath, bool selected);
-    void updateTreeWidgetCheckStates(const QString &scopePath, bool selected);
-    void handleMultiSelection(QTreeWidgetItem *item);
+    void handleMultiSelection(const QModelIndex &index);
 };
 
 #endif // SIGNALSELECTIONDIALOG_H
\ No newline at end of file
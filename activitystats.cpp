@@ -0,0 +1,69 @@
+#include "activitystats.h"
+#include "vcdparser.h"
+
+static bool hasUnknownDigit(const QString &value)
+{
+    for (const QChar c : value)
+    {
+        const ushort u = c.unicode();
+        if (u == 'x' || u == 'X' || u == 'z' || u == 'Z')
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+SignalActivity ActivityStats::analyze(const QString &fullName, int width, const QVector<VCDValueChange> &changes,
+                                      int endTime, int glitchWidth)
+{
+    SignalActivity activity;
+    activity.fullName = fullName;
+    activity.width = width;
+    if (changes.isEmpty())
+    {
+        return activity;
+    }
+
+    // Walk runs of equal values: a run starts at a real change and lasts
+    // until the next one, so repeated writes fold into it
+    int runStart = 0;
+    const QString *runValue = &changes[0].value;
+    const int lastTime = qMax(endTime, changes.last().timestamp);
+
+    for (int i = 1; i <= changes.size(); i++)
+    {
+        const bool atEnd = i == changes.size();
+        if (!atEnd && changes[i].value == *runValue)
+        {
+            continue;
+        }
+
+        const int runEnd = atEnd ? lastTime : changes[i].timestamp;
+        const qint64 length = qint64(runEnd) - runStart;
+        if (width <= 1 && *runValue == QLatin1String("1"))
+        {
+            activity.highTime += length;
+        }
+        if (hasUnknownDigit(*runValue))
+        {
+            activity.unknownTime += length;
+        }
+
+        // Only a run entered and left by a change is a pulse
+        if (runStart > 0 && !atEnd && length < glitchWidth)
+        {
+            activity.glitches++;
+        }
+
+        if (!atEnd)
+        {
+            activity.toggles++;
+            runStart = runEnd;
+            runValue = &changes[i].value;
+        }
+    }
+
+    activity.totalTime = lastTime;
+    return activity;
+}
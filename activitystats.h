@@ -0,0 +1,37 @@
+#ifndef ACTIVITYSTATS_H
+#define ACTIVITYSTATS_H
+
+#include <QString>
+#include <QVector>
+
+struct VCDValueChange;
+
+// NEW: Switching activity of one signal, for power estimation and for
+// finding the hottest nets of a block. Repeated writes of the same value do
+// not count as toggles. The initial value counts from time 0 and the last
+// one lasts until the end of the dump, as in the value histogram.
+struct SignalActivity
+{
+    QString fullName;
+    int width = 1;
+    int toggles = 0;
+    int glitches = 0;        // Pulses shorter than the glitch width
+    qint64 highTime = 0;     // Scalars: time at 1
+    qint64 unknownTime = 0;  // Time with any x or z digit
+    qint64 totalTime = 0;
+
+    // Fraction of the time a scalar is 1, -1 for buses
+    double dutyCycle() const
+    {
+        return width > 1 || totalTime <= 0 ? -1.0 : double(highTime) / totalTime;
+    }
+};
+
+class ActivityStats
+{
+public:
+    static SignalActivity analyze(const QString &fullName, int width, const QVector<VCDValueChange> &changes,
+                                  int endTime, int glitchWidth);
+};
+
+#endif // ACTIVITYSTATS_H
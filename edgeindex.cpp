@@ -0,0 +1,150 @@
+#include "edgeindex.h"
+#include "vcdparser.h"
+#include <QtAlgorithms>
+#include <algorithm>
+
+// Words summed by a rank query past its block entry
+static const int BLOCK_WORDS = 8;
+
+EdgeIndex::EdgeIndex()
+    : changes(0)
+{
+}
+
+EdgeIndex::EdgeIndex(const QVector<VCDValueChange> &changeList)
+    : changes(changeList.size())
+{
+    const int wordCount = (changes + 63) / 64;
+    rises.words.fill(0, wordCount);
+    falls.words.fill(0, wordCount);
+
+    // Scalar values are shared constants, so these compare short strings once
+    // per change, and only here instead of on every navigation
+    for (int i = 1; i < changes; i++)
+    {
+        const QString &previous = changeList[i - 1].value;
+        const QString &current = changeList[i].value;
+        if (previous == QLatin1String("0") && current == QLatin1String("1"))
+        {
+            rises.words[i >> 6] |= quint64(1) << (i & 63);
+        }
+        else if (previous == QLatin1String("1") && current == QLatin1String("0"))
+        {
+            falls.words[i >> 6] |= quint64(1) << (i & 63);
+        }
+    }
+
+    rises.finish();
+    falls.finish();
+}
+
+void EdgeIndex::Bitmap::finish()
+{
+    blockRanks.clear();
+    blockRanks.reserve(words.size() / BLOCK_WORDS + 1);
+
+    quint32 running = 0;
+    for (int w = 0; w < words.size(); w++)
+    {
+        if (w % BLOCK_WORDS == 0)
+        {
+            blockRanks.append(running);
+        }
+        running += qPopulationCount(words[w]);
+    }
+    total = int(running);
+}
+
+int EdgeIndex::Bitmap::rank(int bit) const
+{
+    if (bit <= 0 || words.isEmpty())
+    {
+        return 0;
+    }
+
+    const int word = bit >> 6;
+    if (word >= words.size())
+    {
+        return total;
+    }
+
+    int result = int(blockRanks[word / BLOCK_WORDS]);
+    for (int w = word - word % BLOCK_WORDS; w < word; w++)
+    {
+        result += qPopulationCount(words[w]);
+    }
+
+    const int offset = bit & 63;
+    if (offset > 0)
+    {
+        result += qPopulationCount(words[word] & ((quint64(1) << offset) - 1));
+    }
+    return result;
+}
+
+int EdgeIndex::Bitmap::select(int k) const
+{
+    if (k < 0 || k >= total)
+    {
+        return -1;
+    }
+
+    // Last block whose rank does not exceed k, then at most BLOCK_WORDS words
+    const auto it = std::upper_bound(blockRanks.constBegin(), blockRanks.constEnd(), quint32(k));
+    const int block = int(it - blockRanks.constBegin()) - 1;
+
+    int remaining = k - int(blockRanks[block]);
+    for (int w = block * BLOCK_WORDS; w < words.size(); w++)
+    {
+        quint64 bits = words[w];
+        const int inWord = qPopulationCount(bits);
+        if (remaining >= inWord)
+        {
+            remaining -= inWord;
+            continue;
+        }
+
+        for (; remaining > 0; remaining--)
+        {
+            bits &= bits - 1; // Drop the lowest set bit
+        }
+        return w * 64 + int(qCountTrailingZeroBits(bits));
+    }
+    return -1;
+}
+
+int EdgeIndex::count(Kind kind) const
+{
+    return kind == AnyChange ? changes : bitmap(kind).total;
+}
+
+int EdgeIndex::position(Kind kind, int k) const
+{
+    if (kind == AnyChange)
+    {
+        return (k >= 0 && k < changes) ? k : -1;
+    }
+    return bitmap(kind).select(k);
+}
+
+int EdgeIndex::rank(Kind kind, int changeIndex) const
+{
+    if (kind == AnyChange)
+    {
+        return qBound(0, changeIndex, changes);
+    }
+    return bitmap(kind).rank(changeIndex);
+}
+
+int EdgeIndex::edgeAtOrBefore(Kind kind, const QVector<VCDValueChange> &changeList, int time) const
+{
+    return rank(kind, upperBound(changeList, time)) - 1;
+}
+
+int EdgeIndex::upperBound(const QVector<VCDValueChange> &changeList, int time)
+{
+    const auto it = std::upper_bound(changeList.constBegin(), changeList.constEnd(), time,
+                                     [](int t, const VCDValueChange &change)
+                                     { return t < change.timestamp; });
+    return int(it - changeList.constBegin());
+}
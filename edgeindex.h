@@ -0,0 +1,63 @@
+#ifndef EDGEINDEX_H
+#define EDGEINDEX_H
+
+#include <QVector>
+
+struct VCDValueChange;
+
+// Rising and falling edges of one signal as bitmaps over its value changes,
+// with rank/select so "n-th edge" and "edges before change i" take
+// O(1)-O(log n) instead of a scan. Any change is an event in ValueChange
+// mode, so that kind needs no bitmap: change i is event i.
+class EdgeIndex
+{
+public:
+    enum Kind
+    {
+        AnyChange,
+        Rise, // "0" -> "1"
+        Fall  // "1" -> "0"
+    };
+
+    EdgeIndex();
+    explicit EdgeIndex(const QVector<VCDValueChange> &changeList);
+
+    int changeCount() const { return changes; }
+
+    // Number of edges of a kind
+    int count(Kind kind) const;
+
+    // Change index of the k-th edge (0-based), -1 if there is none
+    int position(Kind kind, int k) const;
+
+    // Edges at change indices below 'changeIndex'
+    int rank(Kind kind, int changeIndex) const;
+
+    // Last edge at or before 'time', -1 if the first edge is later
+    int edgeAtOrBefore(Kind kind, const QVector<VCDValueChange> &changeList, int time) const;
+
+    // First change index whose timestamp is after 'time'
+    static int upperBound(const QVector<VCDValueChange> &changeList, int time);
+
+private:
+    // 64-bit words plus the number of set bits before every block of
+    // BLOCK_WORDS words; about 6% on top of the bits themselves
+    struct Bitmap
+    {
+        QVector<quint64> words;
+        QVector<quint32> blockRanks;
+        int total = 0;
+
+        void finish();
+        int rank(int bit) const;
+        int select(int k) const;
+    };
+
+    const Bitmap &bitmap(Kind kind) const { return kind == Rise ? rises : falls; }
+
+    Bitmap rises;
+    Bitmap falls;
+    int changes;
+};
+
+#endif // EDGEINDEX_H
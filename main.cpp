@@ -1,6 +1,7 @@
 // file: main.cpp
 #include "mainwindow.h"
 #include <QApplication>
+#include <QCommandLineParser>
 
 int main(int argc, char *argv[])
 {
@@ -11,7 +12,15 @@ int main(int argc, char *argv[])
     app.setApplicationVersion("1.0");
     app.setOrganizationName("VCDViewer");
 
-    MainWindow window;
+    // NEW: --stream <fifo|-> reads the dump while the simulator writes it
+    QCommandLineParser parser;
+    parser.setApplicationDescription("VCD Wave Viewer");
+    parser.addHelpOption();
+    QCommandLineOption streamOption("stream", "Read VCD from a named pipe, or - for standard input.", "source");
+    parser.addOption(streamOption);
+    parser.process(app);
+
+    MainWindow window(parser.value(streamOption));
     window.show();
 
     return app.exec();
@@ -1,5 +1,7 @@
 #include "mainwindow.h"
 #include "SignalSelectionDialog.h"
+#include "signalcache.h"
+#include "rtlportscanner.h"
 #include <QTreeWidgetItemIterator>
 #include <QFileInfo>
 #include <QMessageBox>
@@ -23,14 +25,28 @@
 #include <QDialogButtonBox>
 #include <QFileSystemWatcher>
 #include <QTimer>
+#include <QIntValidator>
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QFormLayout>
+#include <QSpinBox>
+#include <climits>
+#include <algorithm>
 
 
 // In the constructor, initialize history
-MainWindow::MainWindow(QWidget *parent)
+MainWindow::MainWindow(const QString &streamSource, QWidget *parent)
     : QMainWindow(parent), vcdParser(new VCDParser(this)),
       rtlProcessedForSignalDialog(false),
+      rtlScanRunning(false),
       currentSearchMatchIndex(-1),
-      lastSearchFormat(2) // INITIALIZE TO HEX (FormatHex = 2)
+      lastSearchFormat(2), // INITIALIZE TO HEX (FormatHex = 2)
+      valueSearchWatcher(nullptr),
+      goldenParser(nullptr),
+      diffWatcher(nullptr),
+      activityQueuePos(0),
+      activityGlitchWidth(1),
+      activityWatcher(nullptr)
 {
     qRegisterMetaType<VCDSignal>("VCDSignal");
     setWindowTitle("VCD Wave Viewer");
@@ -57,9 +73,36 @@ MainWindow::MainWindow(QWidget *parent)
     setupNavigationControls();
     createStatusBar();
 
+    // NEW: Streamed dumps publish their header first, then grow batch by batch
+    connect(vcdParser, &VCDParser::streamHeaderReady, this, [this]()
+            {
+        waveformWidget->setVcdData(vcdParser);
+        waveformWidget->setVisibleSignals(QList<VCDSignal>());
+
+        QString sourceName = (currentStreamSource == "-") ? QString("stdin") : QFileInfo(currentStreamSource).fileName();
+        setWindowTitle(QString("VCD Wave Viewer - %1 (stream)").arg(sourceName));
+        statusLabel->setText(QString("Streaming from %1 (%2 signals)").arg(sourceName).arg(vcdParser->getSignalCount()));
+        updateSaveLoadActions(); });
+    connect(vcdParser, &VCDParser::streamDataAppended, waveformWidget, &WaveformWidget::refreshTimeRange);
+    connect(vcdParser, &VCDParser::streamHistoryTrimmed, this, [this](int fromTime)
+            { statusLabel->setText(QString("Memory budget reached: stream history before time %1 was dropped").arg(fromTime)); });
+
     // NEW: Load history and show startup dialog
     loadHistory();
-    showStartupDialog();
+
+    // NEW: Memory ceiling for loaded signal data
+    QSettings settings(historyFilePath, QSettings::IniFormat);
+    int budgetMB = settings.value("memoryBudgetMB", 2048).toInt();
+    SignalCache::instance().setLimitBytes(qint64(budgetMB) * 1024 * 1024);
+
+    if (!streamSource.isEmpty())
+    {
+        loadVcdStream(streamSource);
+    }
+    else
+    {
+        showStartupDialog();
+    }
 }
 
 void MainWindow::loadHistory()
@@ -286,10 +329,59 @@ void MainWindow::createActions()
     clearValueSearchAction = new QAction("Clear Value Search", this);
     connect(clearValueSearchAction, &QAction::triggered, this, &MainWindow::clearValueSearch);
 
+    valueFrequenciesAction = new QAction("Value Frequencies...", this);
+    connect(valueFrequenciesAction, &QAction::triggered, this, &MainWindow::showValueFrequencies);
+
+    addDerivedSignalAction = new QAction("Add Derived Signal...", this);
+    connect(addDerivedSignalAction, &QAction::triggered, this, &MainWindow::addDerivedSignal);
+
+    // NEW: Comparison actions
+    loadGoldenAction = new QAction("Load Golden VCD...", this);
+    connect(loadGoldenAction, &QAction::triggered, this, &MainWindow::loadGoldenVcd);
+
+    compareSignalsAction = new QAction("Compare Selected Signals", this);
+    connect(compareSignalsAction, &QAction::triggered, this, &MainWindow::compareSelectedSignals);
+
+    compareGoldenAction = new QAction("Compare Against Golden", this);
+    compareGoldenAction->setEnabled(false);
+    connect(compareGoldenAction, &QAction::triggered, this, &MainWindow::compareAgainstGolden);
+
+    clearComparisonAction = new QAction("Clear Comparison", this);
+    connect(clearComparisonAction, &QAction::triggered, this, &MainWindow::clearComparison);
+
+    activityStatsAction = new QAction("Activity Statistics...", this);
+    connect(activityStatsAction, &QAction::triggered, this, &MainWindow::showActivityStatistics);
+
     openAction = new QAction("Open", this);
     openAction->setShortcut(QKeySequence::Open);
     connect(openAction, &QAction::triggered, this, &MainWindow::openFile);
 
+    // NEW: Read a VCD that a simulator is still writing into a pipe
+    openStreamAction = new QAction("Open Stream...", this);
+    connect(openStreamAction, &QAction::triggered, this, &MainWindow::openStream);
+
+    memoryBudgetAction = new QAction("Memory Budget...", this);
+    connect(memoryBudgetAction, &QAction::triggered, this, &MainWindow::setMemoryBudget);
+
+    // NEW: Several dumps in one view
+    addDumpAction = new QAction("Add Dump...", this);
+    connect(addDumpAction, &QAction::triggered, this, &MainWindow::addDump);
+
+    addDumpSignalsAction = new QAction("Add Signals from Dump...", this);
+    addDumpSignalsAction->setEnabled(false);
+    connect(addDumpSignalsAction, &QAction::triggered, this, &MainWindow::addSignalsFromDump);
+
+    dumpOffsetAction = new QAction("Dump Time Offset...", this);
+    dumpOffsetAction->setEnabled(false);
+    connect(dumpOffsetAction, &QAction::triggered, this, &MainWindow::setDumpTimeOffset);
+
+    removeDumpAction = new QAction("Remove Dump...", this);
+    removeDumpAction->setEnabled(false);
+    connect(removeDumpAction, &QAction::triggered, this, &MainWindow::removeDump);
+
+    openTimeWindowAction = new QAction("Open Time Window...", this);
+    connect(openTimeWindowAction, &QAction::triggered, this, &MainWindow::openFileTimeWindow);
+
     // NEW: Save/Load signals actions
     saveSignalsAction = new QAction("Save Signals As...", this);
     saveSignalsAction->setShortcut(QKeySequence::SaveAs);
@@ -317,6 +409,11 @@ void MainWindow::createActions()
     zoomFitAction = new QAction("Zoom Fit", this);
     connect(zoomFitAction, &QAction::triggered, this, &MainWindow::zoomFit);
 
+    // NEW: Per-cycle view on a clock
+    cycleViewAction = new QAction("Cycle View on Selected Clock", this);
+    cycleViewAction->setCheckable(true);
+    connect(cycleViewAction, &QAction::triggered, this, &MainWindow::toggleCycleView);
+
     aboutAction = new QAction("About", this);
     connect(aboutAction, &QAction::triggered, this, &MainWindow::about);
 
@@ -464,6 +561,8 @@ void MainWindow::createMenuBar()
     // File menu
     QMenu *fileMenu = menuBar->addMenu("File");
     fileMenu->addAction(openAction);
+    fileMenu->addAction(openTimeWindowAction);
+    fileMenu->addAction(openStreamAction);
     
     // NEW: Add save/load signals actions
     fileMenu->addAction(saveSignalsAction);
@@ -483,9 +582,17 @@ void MainWindow::createMenuBar()
     viewMenu->addAction(zoomInAction);
     viewMenu->addAction(zoomOutAction);
     viewMenu->addAction(zoomFitAction);
+    viewMenu->addSeparator();
+    viewMenu->addAction(cycleViewAction);
 
-    // Workspace menu (empty for now)
+    // Workspace menu
     QMenu *workspaceMenu = menuBar->addMenu("Workspace");
+    workspaceMenu->addAction(memoryBudgetAction);
+    workspaceMenu->addSeparator();
+    workspaceMenu->addAction(addDumpAction);
+    workspaceMenu->addAction(addDumpSignalsAction);
+    workspaceMenu->addAction(dumpOffsetAction);
+    workspaceMenu->addAction(removeDumpAction);
 
     // Wave menu with submenus
     QMenu *waveMenu = menuBar->addMenu("Wave");
@@ -498,6 +605,10 @@ void MainWindow::createMenuBar()
     waveMenu->addAction(findNextValueAction);
     waveMenu->addAction(findPreviousValueAction);
     waveMenu->addAction(clearValueSearchAction);
+    waveMenu->addAction(valueFrequenciesAction);
+    waveMenu->addSeparator();
+    waveMenu->addAction(addDerivedSignalAction);
+    waveMenu->addAction(activityStatsAction);
     waveMenu->addSeparator();
 
     // Signal colors submenu
@@ -516,6 +627,15 @@ void MainWindow::createMenuBar()
     lineThicknessMenu->addAction(lineThinAction);
     lineThicknessMenu->addAction(lineMediumAction);
 
+    // NEW: Compare menu
+    QMenu *compareMenu = menuBar->addMenu("Compare");
+    compareMenu->addAction(compareSignalsAction);
+    compareMenu->addSeparator();
+    compareMenu->addAction(loadGoldenAction);
+    compareMenu->addAction(compareGoldenAction);
+    compareMenu->addSeparator();
+    compareMenu->addAction(clearComparisonAction);
+
     // Help menu
     QMenu *helpMenu = menuBar->addMenu("Help");
     helpMenu->addAction(aboutAction);
@@ -674,29 +794,19 @@ void MainWindow::showAddSignalsDialog()
     if (!vcdParser)
         return;
 
-    int signalCount = vcdParser->getSignals().size();
+    int signalCount = vcdParser->getSignalCount();
 
     // Show immediate feedback for large files
     if (signalCount > 10000)
     {
         statusLabel->setText(QString("Loading signal selection dialog (%1 signals)...").arg(signalCount));
         QApplication::processEvents();
-
-        // Use a simple message box for very large files
-        if (signalCount > 50000)
-        {
-            QMessageBox::information(this, "Large File",
-                                     QString("This file contains %1 signals.\n\n"
-                                             "The signal selection will load in batches for better performance.\n"
-                                             "Use the search filter to find specific signals quickly.")
-                                         .arg(signalCount));
-        }
     }
 
     SignalSelectionDialog dialog(this);
 
     // NEW: Set up RTL processing for signal dialog
-    dialog.setRtlProcessingInfo(this, currentVcdFilePath, rtlProcessedForSignalDialog, tempVcdFilePathForSignalDialog);
+    dialog.setRtlProcessingInfo(this, currentVcdFilePath, rtlProcessedForSignalDialog);
 
     // Get current signals
     QList<VCDSignal> currentSignals;
@@ -710,7 +820,7 @@ void MainWindow::showAddSignalsDialog()
     }
 
     // Set signals and show dialog
-    dialog.setAvailableSignals(vcdParser->getSignals(), currentSignals);
+    dialog.setAvailableSignals(vcdParser, currentSignals);
 
     if (dialog.exec() == QDialog::Accepted)
     {
@@ -754,23 +864,241 @@ void MainWindow::showAddSignalsDialog()
             updateSaveLoadActions();
         }
     }
+}
+
+// Placed like signals from the Add Signals dialog: at the signal cursor, or
+// appended
+void MainWindow::addSignalsToView(const QList<VCDSignal> &newSignals)
+{
+    int cursorIndex = waveformWidget->getSignalCursorIndex();
+    if (cursorIndex >= 0)
+    {
+        waveformWidget->insertSignalsAtCursor(newSignals, cursorIndex);
+        return;
+    }
 
-    // REMOVED: Don't clean up temp file here - keep it for the session
-    // if (QFile::exists(tempVcdFilePathForSignalDialog)) {
-    //     QFile::remove(tempVcdFilePathForSignalDialog);
-    // }
-    // rtlProcessedForSignalDialog = false; // Don't reset this either
+    QList<VCDSignal> allSignalsToDisplay;
+    for (int i = 0; i < waveformWidget->getItemCount(); i++)
+    {
+        const DisplayItem *item = waveformWidget->getItem(i);
+        if (item && item->type == DisplayItem::Signal)
+        {
+            allSignalsToDisplay.append(item->signal.signal);
+        }
+    }
+    allSignalsToDisplay.append(newSignals);
+    waveformWidget->setVisibleSignals(allSignalsToDisplay);
 }
 
-void MainWindow::closeEvent(QCloseEvent *event)
+void MainWindow::addDump()
+{
+    QString filename = QFileDialog::getOpenFileName(
+        this, "Add VCD Dump", QFileInfo(currentVcdFilePath).absolutePath(), "VCD Files (*.vcd)");
+    if (filename.isEmpty())
+        return;
+
+    // Rows are named "label:scope.signal", so labels must be unique
+    QString label = QFileInfo(filename).completeBaseName();
+    QString base = label;
+    for (int n = 2;; n++)
+    {
+        bool taken = false;
+        for (const OpenDump &dump : extraDumps)
+            taken = taken || dump.label == label;
+        if (!taken)
+            break;
+        label = QString("%1_%2").arg(base).arg(n);
+    }
+
+    VCDParser *parser = new VCDParser(this);
+    addDumpAction->setEnabled(false);
+    statusLabel->setText(QString("Loading %1...").arg(QFileInfo(filename).fileName()));
+
+    // Header only, like the main dump; data is loaded per row on demand
+    QFutureWatcher<bool> *watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher, parser, filename, label]()
+            {
+        watcher->deleteLater();
+        addDumpAction->setEnabled(true);
+
+        if (!watcher->result()) {
+            QMessageBox::critical(this, "Error", "Failed to parse VCD file: " + parser->getError());
+            statusLabel->setText("Ready");
+            parser->deleteLater();
+            return;
+        }
+
+        extraDumps.append({label, filename, parser});
+        addDumpSignalsAction->setEnabled(true);
+        dumpOffsetAction->setEnabled(true);
+        removeDumpAction->setEnabled(true);
+        statusLabel->setText(QString("Added dump %1 (%2 signals)").arg(label).arg(parser->getSignalCount())); });
+    watcher->setFuture(QtConcurrent::run([parser, filename]() { return parser->parseHeaderOnly(filename); }));
+}
+
+// Index into extraDumps, asking when there is more than one; -1 if cancelled
+int MainWindow::chooseDump(const QString &title)
 {
-    // Clean up signal dialog temp file when application closes
-    if (QFile::exists(tempVcdFilePathForSignalDialog))
+    if (extraDumps.isEmpty())
+        return -1;
+    if (extraDumps.size() == 1)
+        return 0;
+
+    QStringList labels;
+    for (const OpenDump &dump : extraDumps)
+        labels.append(QString("%1 (%2)").arg(dump.label, dump.filePath));
+
+    bool ok = false;
+    QString choice = QInputDialog::getItem(this, title, "Dump:", labels, 0, false, &ok);
+    return ok ? labels.indexOf(choice) : -1;
+}
+
+void MainWindow::addSignalsFromDump()
+{
+    if (vcdParser->getSignalCount() == 0)
+    {
+        QMessageBox::information(this, "Add Signals from Dump", "Open the main VCD file first.");
+        return;
+    }
+
+    int index = chooseDump("Add Signals from Dump");
+    if (index < 0)
+        return;
+    const OpenDump dump = extraDumps[index];
+
+    SignalSelectionDialog dialog(this);
+    dialog.setWindowTitle(QString("Add Signals from %1").arg(dump.label));
+    dialog.setAvailableSignals(dump.parser, QList<VCDSignal>());
+    if (dialog.exec() != QDialog::Accepted)
+        return;
+
+    QList<VCDSignal> linkedSignals;
+    for (const VCDSignal &signal : dialog.getSelectedSignals())
+    {
+        VCDSignal linked;
+        if (vcdParser->addLinkedSignal(dump.label, dump.parser, signal.fullName, &linked))
+        {
+            linkedSignals.append(linked);
+        }
+        else
+        {
+            qDebug() << "Cannot link" << signal.fullName << ":" << vcdParser->getError();
+        }
+    }
+    if (linkedSignals.isEmpty())
+        return;
+
+    addSignalsToView(linkedSignals);
+    waveformWidget->refreshTimeRange(); // The other dump may run longer
+    statusLabel->setText(QString("Added %1 signal(s) from %2").arg(linkedSignals.size()).arg(dump.label));
+    updateSaveLoadActions();
+}
+
+void MainWindow::setDumpTimeOffset()
+{
+    int index = chooseDump("Dump Time Offset");
+    if (index < 0)
+        return;
+    const OpenDump dump = extraDumps[index];
+
+    bool ok = false;
+    int offset = QInputDialog::getInt(this, "Dump Time Offset",
+                                      QString("Shift the rows of %1 by this much time\n"
+                                              "(positive values move them later):")
+                                          .arg(dump.label),
+                                      vcdParser->getLinkedTimeOffset(dump.parser), INT_MIN / 2, INT_MAX / 2, 1, &ok);
+    if (!ok)
+        return;
+
+    vcdParser->setLinkedTimeOffset(dump.parser, offset);
+    waveformWidget->refreshTimeRange();
+    waveformWidget->update();
+    statusLabel->setText(QString("%1 shifted by %2").arg(dump.label).arg(offset));
+}
+
+void MainWindow::removeDump()
+{
+    int index = chooseDump("Remove Dump");
+    if (index < 0)
+        return;
+    const OpenDump dump = extraDumps.takeAt(index);
+
+    // Its rows go first, then the links to it, then the parser itself
+    const QString prefix = dump.label + ":";
+    QSet<QString> rows;
+    for (int i = 0; i < waveformWidget->getItemCount(); i++)
+    {
+        const DisplayItem *item = waveformWidget->getItem(i);
+        if (item && item->type == DisplayItem::Signal && item->signal.signal.fullName.startsWith(prefix) &&
+            vcdParser->isDerivedSignal(item->signal.signal.fullName))
+        {
+            rows.insert(item->signal.signal.fullName);
+        }
+    }
+
+    if (!waveformWidget->getCycleClock().isEmpty() && rows.contains(waveformWidget->getCycleClock()))
+    {
+        cycleViewAction->setChecked(false);
+        waveformWidget->setCycleClock(QString());
+    }
+    waveformWidget->removeSignals(rows);
+    vcdParser->removeLinkedSignals(dump.parser);
+    dump.parser->deleteLater(); // Waits for its background loads
+
+    const bool anyLeft = !extraDumps.isEmpty();
+    addDumpSignalsAction->setEnabled(anyLeft);
+    dumpOffsetAction->setEnabled(anyLeft);
+    removeDumpAction->setEnabled(anyLeft);
+
+    waveformWidget->refreshTimeRange();
+    updateTimeDisplay(waveformWidget->getCursorTime());
+    updateSaveLoadActions();
+    statusLabel->setText(QString("Removed dump %1 and %2 row(s)").arg(dump.label).arg(rows.size()));
+}
+
+void MainWindow::addDerivedSignal()
+{
+    if (!vcdParser || vcdParser->getSignalCount() == 0)
+    {
+        QMessageBox::information(this, "Add Derived Signal", "Open a VCD file first.");
+        return;
+    }
+
+    bool ok = false;
+    QString expression = QInputDialog::getText(this, "Add Derived Signal",
+                                               "Expression over signal names, e.g.\n"
+                                               "  top.valid & top.ready\n"
+                                               "  top.addr[31:12]\n"
+                                               "  top.count_a - top.count_b\n"
+                                               "Operators: ~ ! - * / % + - << >> < <= > >= == != & ^ | && ||",
+                                               QLineEdit::Normal, QString(), &ok);
+    if (!ok || expression.trimmed().isEmpty())
+        return;
+
+    static int derivedCount = 0;
+    QString name = QInputDialog::getText(this, "Add Derived Signal", "Name of the new signal:",
+                                         QLineEdit::Normal, QString("derived_%1").arg(++derivedCount), &ok);
+    if (!ok)
+        return;
+
+    VCDSignal signal;
+    if (!vcdParser->addDerivedSignal(name, expression, &signal))
     {
-        QFile::remove(tempVcdFilePathForSignalDialog);
-        qDebug() << "Cleaned up signal dialog temp file:" << tempVcdFilePathForSignalDialog;
+        QMessageBox::warning(this, "Add Derived Signal", vcdParser->getError());
+        return;
     }
 
+    addSignalsToView({signal});
+    statusLabel->setText(QString("Added %1 = %2").arg(signal.fullName, vcdParser->getDerivedExpression(signal.fullName)));
+    updateSaveLoadActions();
+}
+
+void MainWindow::closeEvent(QCloseEvent *event)
+{
+    cancelValueSearch();
+    cancelComparison();
+    cancelActivityAnalysis();
+
     // NEW: Clean up file watcher
     if (!currentVcdFilePath.isEmpty())
     {
@@ -833,7 +1161,154 @@ void MainWindow::openFile()
     }
 }
 
-void MainWindow::loadVcdFile(const QString &filename)
+void MainWindow::openFileTimeWindow()
+{
+    QString filename = QFileDialog::getOpenFileName(
+        this, "Open VCD File (Time Window)", "", "VCD Files (*.vcd)");
+
+    if (filename.isEmpty())
+        return;
+
+    QDialog dialog(this);
+    dialog.setWindowTitle("Load Time Window");
+
+    QVBoxLayout *layout = new QVBoxLayout(&dialog);
+    layout->addWidget(new QLabel("Only value changes inside this range will be loaded.\n"
+                                 "Each signal keeps its value at the start time."));
+
+    QHBoxLayout *rangeLayout = new QHBoxLayout();
+    QLineEdit *startEdit = new QLineEdit("0");
+    QLineEdit *endEdit = new QLineEdit();
+    startEdit->setValidator(new QIntValidator(0, INT_MAX, startEdit));
+    endEdit->setValidator(new QIntValidator(0, INT_MAX, endEdit));
+    endEdit->setPlaceholderText("end time");
+    rangeLayout->addWidget(new QLabel("From:"));
+    rangeLayout->addWidget(startEdit);
+    rangeLayout->addWidget(new QLabel("To:"));
+    rangeLayout->addWidget(endEdit);
+    layout->addLayout(rangeLayout);
+
+    QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+    connect(buttonBox, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttonBox, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    layout->addWidget(buttonBox);
+
+    if (dialog.exec() != QDialog::Accepted)
+        return;
+
+    int windowStart = startEdit->text().toInt();
+    int windowEnd = endEdit->text().isEmpty() ? INT_MAX : endEdit->text().toInt();
+    if (windowEnd < windowStart)
+    {
+        QMessageBox::warning(this, "Load Time Window", "The end time must not be before the start time.");
+        return;
+    }
+
+    loadVcdFile(filename, windowStart, windowEnd);
+}
+
+void MainWindow::setMemoryBudget()
+{
+    SignalCache &cache = SignalCache::instance();
+    int currentMB = static_cast<int>(cache.limitBytes() / (1024 * 1024));
+    int usedMB = static_cast<int>(cache.usedBytes() / (1024 * 1024));
+
+    bool ok = false;
+    int budgetMB = QInputDialog::getInt(this, "Memory Budget",
+                                        QString("Maximum memory for loaded signal data in MB\n"
+                                                "(currently using %1 MB). Least recently drawn\n"
+                                                "signals are dropped and reloaded when needed.")
+                                            .arg(usedMB),
+                                        currentMB, 64, 1024 * 1024, 64, &ok);
+    if (!ok)
+        return;
+
+    cache.setLimitBytes(qint64(budgetMB) * 1024 * 1024);
+
+    QSettings settings(historyFilePath, QSettings::IniFormat);
+    settings.setValue("memoryBudgetMB", budgetMB);
+
+    statusLabel->setText(QString("Memory budget set to %1 MB").arg(budgetMB));
+    waveformWidget->update();
+}
+
+void MainWindow::openStream()
+{
+    bool ok = false;
+    QString source = QInputDialog::getText(this, "Open VCD Stream",
+                                           "Named pipe (FIFO) path, or - for standard input:",
+                                           QLineEdit::Normal, currentStreamSource, &ok)
+                         .trimmed();
+
+    if (ok && !source.isEmpty())
+    {
+        loadVcdStream(source);
+    }
+}
+
+void MainWindow::loadVcdStream(const QString &source)
+{
+    // A stream is read once and never touches the disk: nothing to watch,
+    // no recent-files entry and no session file
+    if (!currentVcdFilePath.isEmpty())
+    {
+        fileWatcher->removePath(currentVcdFilePath);
+    }
+    currentVcdFilePath.clear();
+    currentStreamSource = source;
+    rtlProcessedForSignalDialog = false;
+    cancelValueSearch();
+    clearComparison();
+    cancelActivityAnalysis();
+    cycleViewAction->setChecked(false);
+
+    // Drop rows of the previous dump before the parser resets its tables
+    vcdParser->cancelStream();
+    waveformWidget->setVisibleSignals(QList<VCDSignal>());
+    updateSaveLoadActions();
+
+    QString sourceName = (source == "-") ? QString("stdin") : QFileInfo(source).fileName();
+
+    QProgressBar *progressBar = new QProgressBar();
+    progressBar->setRange(0, 0);
+    progressBar->setMaximumWidth(200);
+    progressBar->setTextVisible(false);
+    statusBar()->addPermanentWidget(progressBar);
+
+    statusLabel->setText(QString("Waiting for VCD stream on %1...").arg(sourceName));
+
+    // The UI stays enabled: signals can be added as soon as the header is in
+    QFuture<bool> streamFuture = vcdParser->readStream(source);
+
+    QFutureWatcher<bool> *watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, progressBar, watcher, source, sourceName]()
+            {
+        bool success = watcher->result();
+
+        statusBar()->removeWidget(progressBar);
+        delete progressBar;
+        watcher->deleteLater();
+
+        if (source != currentStreamSource) {
+            return; // Another dump was opened meanwhile
+        }
+
+        if (success) {
+            waveformWidget->refreshTimeRange();
+            statusLabel->setText(QString("Stream %1 closed at time %2 (%3 signals)")
+                                     .arg(sourceName)
+                                     .arg(vcdParser->getEndTime())
+                                     .arg(vcdParser->getSignalCount()));
+        } else {
+            QMessageBox::critical(this, "Error",
+                                  "Failed to read VCD stream: " + vcdParser->getError());
+            statusLabel->setText("Ready");
+        } });
+
+    watcher->setFuture(streamFuture);
+}
+
+void MainWindow::loadVcdFile(const QString &filename, int windowStart, int windowEnd)
 {
     // NEW: Remove previous file from watcher
     if (!currentVcdFilePath.isEmpty())
@@ -844,12 +1319,13 @@ void MainWindow::loadVcdFile(const QString &filename)
     // NEW: Add to history
     addToHistory(filename);
 
-    // NEW: Clean up previous temp files when loading a new VCD file
-    if (QFile::exists(tempVcdFilePathForSignalDialog))
-    {
-        QFile::remove(tempVcdFilePathForSignalDialog);
-        qDebug() << "Cleaned up previous signal dialog temp file:" << tempVcdFilePathForSignalDialog;
-    }
+    // NEW: Stop reading any stream that is still feeding the parser
+    vcdParser->cancelStream();
+    cancelValueSearch();
+    clearComparison();
+    cancelActivityAnalysis();
+    cycleViewAction->setChecked(false);
+    currentStreamSource.clear();
 
     // Reset RTL processing state for the new file
     rtlProcessedForSignalDialog = false;
@@ -884,7 +1360,7 @@ void MainWindow::loadVcdFile(const QString &filename)
 
     // Create a watcher to handle completion
     QFutureWatcher<bool> *watcher = new QFutureWatcher<bool>(this);
-    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, progressBar, watcher, vcdToLoad]()
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, progressBar, watcher, vcdToLoad, windowStart, windowEnd]()
             {
         bool success = watcher->result();
         
@@ -897,7 +1373,13 @@ void MainWindow::loadVcdFile(const QString &filename)
         watcher->deleteLater();
         
         if (success) {
-            QString statusMessage = QString("Loaded: %1 (%2 signals)").arg(QFileInfo(vcdToLoad).fileName()).arg(vcdParser->getSignals().size());
+            QString statusMessage = QString("Loaded: %1 (%2 signals)").arg(QFileInfo(vcdToLoad).fileName()).arg(vcdParser->getSignalCount());
+
+            // NEW: Partial load of a huge dump
+            if (windowEnd >= 0) {
+                vcdParser->setTimeWindow(windowStart, windowEnd);
+                statusMessage += QString(", time window %1 - %2").arg(vcdParser->getWindowStart()).arg(vcdParser->getWindowEnd());
+            }
             statusLabel->setText(statusMessage);
 
             // Pass parser to waveform widget but don't load all signals
@@ -907,7 +1389,11 @@ void MainWindow::loadVcdFile(const QString &filename)
             waveformWidget->setVisibleSignals(QList<VCDSignal>());
             
             // NEW: Update window title to show current file
-            setWindowTitle(QString("VCD Wave Viewer - %1").arg(QFileInfo(vcdToLoad).fileName()));
+            QString title = QString("VCD Wave Viewer - %1").arg(QFileInfo(vcdToLoad).fileName());
+            if (windowEnd >= 0) {
+                title += QString(" [%1 - %2]").arg(windowStart).arg(windowEnd);
+            }
+            setWindowTitle(title);
             
             // NEW: Update save/load actions state
             updateSaveLoadActions();
@@ -937,9 +1423,50 @@ void MainWindow::zoomFit()
 
 void MainWindow::updateTimeDisplay(int time)
 {
+    // NEW: In cycle view the clock cycle comes first
+    if (waveformWidget->isCycleView())
+    {
+        timeLabel->setText(QString("Cycle %1 (Time: %2)").arg(waveformWidget->cycleAtTime(time)).arg(time));
+        return;
+    }
     timeLabel->setText(QString("Time: %1").arg(time));
 }
 
+void MainWindow::toggleCycleView()
+{
+    if (!cycleViewAction->isChecked())
+    {
+        waveformWidget->setCycleClock(QString());
+        statusLabel->setText("Time view");
+        return;
+    }
+
+    const DisplayItem *item = waveformWidget->getItem(waveformWidget->getSelectedSignal());
+    if (!item || item->type != DisplayItem::Signal || item->signal.signal.width != 1)
+    {
+        QMessageBox::information(this, "Cycle View", "Select a 1-bit clock signal first.");
+        cycleViewAction->setChecked(false);
+        return;
+    }
+
+    const QString clock = item->signal.signal.fullName;
+    waveformWidget->setCycleClock(clock);
+    if (waveformWidget->isCycleView())
+    {
+        statusLabel->setText(QString("Cycle view on %1: %2 rising edges").arg(clock).arg(waveformWidget->cycleCount()));
+    }
+    else if (vcdParser->isSignalLoading(clock))
+    {
+        statusLabel->setText(QString("Cycle view on %1: waiting for its data...").arg(clock));
+    }
+    else
+    {
+        waveformWidget->setCycleClock(QString());
+        cycleViewAction->setChecked(false);
+        QMessageBox::information(this, "Cycle View", QString("%1 has no rising edges.").arg(clock));
+    }
+}
+
 void MainWindow::about()
 {
     QMessageBox::about(this, "About VCD Wave Viewer",
@@ -1162,133 +1689,74 @@ void MainWindow::updateNavigationButtons()
     }
 }
 
-bool MainWindow::runVcdPortMapperForSignalDialog(const QString &inputVcd, const QString &outputVcd, const QString &rtlDir)
+void MainWindow::applyRtlPortsForSignalDialog(const QString &rtlDir, std::function<void(bool)> done)
 {
-    // Get the path to the Python script
-    QString pythonScript = QCoreApplication::applicationDirPath() + "/vcd_port_mapper.py";
-
-    // If script doesn't exist in application dir, try current dir
-    if (!QFile::exists(pythonScript))
-    {
-        pythonScript = "vcd_port_mapper.py";
-    }
-
-    if (!QFile::exists(pythonScript))
+    if (rtlScanRunning)
     {
-        qDebug() << "VCD port mapper script not found:" << pythonScript;
-        return false;
+        qDebug() << "RTL port scan already running, ignoring" << rtlDir;
+        done(false);
+        return;
     }
 
-    // Convert paths to absolute paths to avoid any relative path issues
-    QString absInputVcd = QFileInfo(inputVcd).absoluteFilePath();
-    QString absOutputVcd = QFileInfo(outputVcd).absoluteFilePath();
     QString absRtlDir = QFileInfo(rtlDir).absoluteFilePath();
-    QString absPythonScript = QFileInfo(pythonScript).absoluteFilePath();
-
-    qDebug() << "=== VCD PORT MAPPER EXECUTION ===";
-    qDebug() << "Python script:" << absPythonScript;
-    qDebug() << "Input VCD:" << absInputVcd;
-    qDebug() << "Output VCD:" << absOutputVcd;
+    qDebug() << "=== RTL PORT SCAN ===";
     qDebug() << "RTL Directory:" << absRtlDir;
-    qDebug() << "RTL Directory exists:" << QDir(absRtlDir).exists();
 
-    // Check if RTL directory exists and has files
-    QDir rtlDirectory(absRtlDir);
-    QStringList rtlFiles = rtlDirectory.entryList(QStringList() << "*.v" << "*.sv", QDir::Files);
-    qDebug() << "RTL files found:" << rtlFiles.size();
-    if (rtlFiles.size() > 0)
+    // Directions from an earlier directory must not linger
+    vcdParser->clearPortDirections();
+
+    QSharedPointer<RtlPortScanner> scanner(new RtlPortScanner());
+    QFuture<RtlFileJob> future;
+    if (!scanner->beginScanDirectory(absRtlDir, &future))
     {
-        qDebug() << "First few RTL files:" << rtlFiles.mid(0, 5);
+        qDebug() << "RTL port scan failed:" << scanner->getError();
+        done(false);
+        return;
     }
 
-    // Prepare the command - use absolute paths
-    QStringList arguments;
-    arguments << absPythonScript << absInputVcd << "-o" << absOutputVcd << "-r" << absRtlDir;
+    // Sources are parsed on the pool; the dialog stays responsive meanwhile
+    rtlScanRunning = true;
+    const QString scannedVcdFile = currentVcdFilePath;
+    QFutureWatcher<RtlFileJob> *watcher = new QFutureWatcher<RtlFileJob>(this);
+    connect(watcher, &QFutureWatcher<RtlFileJob>::finished, this, [this, watcher, scanner, scannedVcdFile, done]() {
+        rtlScanRunning = false;
+        bool ok = scanner->finishScan(watcher->future());
+        watcher->deleteLater();
 
-    qDebug() << "Command: python" << arguments;
+        // Another dump was opened while the sources were being read
+        if (scannedVcdFile != currentVcdFilePath)
+        {
+            qDebug() << "RTL port scan finished for a dump that is no longer open";
+            done(false);
+            return;
+        }
+        if (!ok)
+        {
+            qDebug() << "RTL port scan failed:" << scanner->getError();
+            done(false);
+            return;
+        }
 
-    QProcess process;
-    process.setProcessChannelMode(QProcess::MergedChannels); // Merge stdout and stderr
+        int applied = scanner->applyTo(*vcdParser);
+        qDebug() << "Modules found:" << scanner->getModuleCount() << "Port signals:" << applied;
 
-    // Connect to readyRead signal to capture output in real-time
-    QObject::connect(&process, &QProcess::readyRead, [&process]()
-                     {
-        QByteArray output = process.readAll();
-        qDebug() << "Python output:" << output.trimmed(); });
+        // No matching module means the RTL does not describe this dump
+        done(applied > 0);
+    });
+    watcher->setFuture(future);
+}
 
-    process.start("python", arguments);
+QString MainWindow::findRtlDirectoryForSignalDialog(const QString &vcdFile)
+{
+    QFileInfo vcdInfo(vcdFile);
+    QDir vcdDir = vcdInfo.dir();
 
-    if (!process.waitForStarted(5000))
-    {
-        qDebug() << "Failed to start VCD port mapper process";
-        qDebug() << "Error:" << process.errorString();
-        return false;
-    }
+    qDebug() << "=== FINDING RTL DIRECTORY ===";
+    qDebug() << "VCD file:" << vcdFile;
+    qDebug() << "VCD directory:" << vcdDir.absolutePath();
 
-    qDebug() << "Process started successfully";
-
-    if (!process.waitForFinished(60000))
-    { // 60 second timeout
-        qDebug() << "VCD port mapper timed out";
-        process.kill();
-        return false;
-    }
-
-    int exitCode = process.exitCode();
-    QByteArray allOutput = process.readAll();
-
-    qDebug() << "Process finished with exit code:" << exitCode;
-    qDebug() << "Final output:" << allOutput.trimmed();
-
-    if (exitCode != 0)
-    {
-        qDebug() << "VCD port mapper failed with exit code:" << exitCode;
-        return false;
-    }
-
-    // Verify the output file was created
-    if (QFile::exists(absOutputVcd))
-    {
-        QFile outputFile(absOutputVcd);
-        if (outputFile.open(QIODevice::ReadOnly))
-        {
-            qDebug() << "Output file created successfully, size:" << outputFile.size() << "bytes";
-            outputFile.close();
-
-            // Quick check if the file has the expected content
-            if (outputFile.size() > 100)
-            { // Reasonable minimum size
-                qDebug() << "VCD port mapper completed successfully";
-                return true;
-            }
-            else
-            {
-                qDebug() << "Output file seems too small, might be empty";
-                return false;
-            }
-        }
-    }
-    else
-    {
-        qDebug() << "Output file was not created";
-        return false;
-    }
-
-    qDebug() << "VCD port mapper completed successfully";
-    return true;
-}
-
-QString MainWindow::findRtlDirectoryForSignalDialog(const QString &vcdFile)
-{
-    QFileInfo vcdInfo(vcdFile);
-    QDir vcdDir = vcdInfo.dir();
-
-    qDebug() << "=== FINDING RTL DIRECTORY ===";
-    qDebug() << "VCD file:" << vcdFile;
-    qDebug() << "VCD directory:" << vcdDir.absolutePath();
-
-    // First, check if there's a directory that contains RTL files
-    // We'll look for directories that have Verilog/SystemVerilog files
+    // First, check if there's a directory that contains RTL files
+    // We'll look for directories that have Verilog/SystemVerilog files
 
     QDir parentDir = vcdDir;
 
@@ -1326,84 +1794,48 @@ QString MainWindow::findRtlDirectoryForSignalDialog(const QString &vcdFile)
     return "";
 }
 
-bool MainWindow::processVcdWithRtlForSignalDialog(const QString &vcdFile)
+void MainWindow::processVcdWithRtlForSignalDialog(const QString &vcdFile, std::function<void(bool)> done)
 {
     QString rtlDir = findRtlDirectoryForSignalDialog(vcdFile);
     if (rtlDir.isEmpty())
     {
         qDebug() << "No RTL directory found for signal dialog";
-        return false;
+        done(false);
+        return;
     }
 
-    // Create temp VCD file path for signal dialog
-    QFileInfo fileInfo(vcdFile);
-    tempVcdFilePathForSignalDialog = fileInfo.path() + "/" + fileInfo.completeBaseName() + "_temp_signal_dialog.vcd";
-
     qDebug() << "Processing VCD with RTL for signal dialog:";
-    qDebug() << "  Input VCD:" << vcdFile;
+    qDebug() << "  VCD:" << vcdFile;
     qDebug() << "  RTL Dir:" << rtlDir;
-    qDebug() << "  Output VCD:" << tempVcdFilePathForSignalDialog;
-
-    bool success = runVcdPortMapperForSignalDialog(vcdFile, tempVcdFilePathForSignalDialog, rtlDir);
 
-    if (success)
-    {
-        // Verify the output file was created
-        if (QFile::exists(tempVcdFilePathForSignalDialog))
+    applyRtlPortsForSignalDialog(rtlDir, [done](bool success) {
+        if (!success)
         {
-            QFile file(tempVcdFilePathForSignalDialog);
-            if (file.open(QIODevice::ReadOnly))
-            {
-                qDebug() << "RTL processing successful, output file size:" << file.size() << "bytes";
-                file.close();
-            }
+            qDebug() << "RTL processing failed";
         }
-    }
-    else
-    {
-        qDebug() << "RTL processing failed";
-    }
-
-    return success;
+        done(success);
+    });
 }
 
-void MainWindow::showRtlDirectoryDialogForSignalDialog()
+void MainWindow::showRtlDirectoryDialogForSignalDialog(std::function<void(bool)> done)
 {
     QString rtlDir = QFileDialog::getExistingDirectory(this, "Select RTL Directory for Signal Filtering",
                                                        QFileInfo(currentVcdFilePath).dir().path());
 
-    if (!rtlDir.isEmpty())
+    if (rtlDir.isEmpty())
     {
-        // Reprocess VCD with the new RTL directory for signal dialog
-        if (runVcdPortMapperForSignalDialog(currentVcdFilePath, tempVcdFilePathForSignalDialog, rtlDir))
+        done(false);
+        return;
+    }
+
+    // Reprocess VCD with the new RTL directory for signal dialog
+    applyRtlPortsForSignalDialog(rtlDir, [this, done](bool success) {
+        if (success)
         {
             rtlProcessedForSignalDialog = true;
         }
-    }
-}
-
-// You can add this check somewhere in your initialization
-void checkPythonAvailability()
-{
-    QProcess process;
-    process.start("python", QStringList() << "--version");
-    if (process.waitForFinished(5000))
-    {
-        QByteArray output = process.readAll();
-        qDebug() << "Python version:" << output.trimmed();
-    }
-    else
-    {
-        qDebug() << "Python not found or not working";
-    }
-
-    // Also check python3
-    process.start("python3", QStringList() << "--version");
-    if (process.waitForFinished(5000))
-    {
-        QByteArray output = process.readAll();
-        qDebug() << "Python3 version:" << output.trimmed();
-    }
+        done(success);
+    });
 }
 
 QString MainWindow::getSessionFilePath(const QString &vcdFile) const
@@ -1501,6 +1933,12 @@ void MainWindow::saveSignals()
         const DisplayItem *item = waveformWidget->getItem(i);
         if (item && item->type == DisplayItem::Signal)
         {
+            // NEW: Derived and linked rows exist only in this window
+            if (vcdParser->isDerivedSignal(item->signal.signal.fullName))
+            {
+                continue;
+            }
+
             QJsonObject signalObj;
             signalObj["fullName"] = item->signal.signal.fullName;
             signalObj["scope"] = item->signal.signal.scope;
@@ -1642,7 +2080,6 @@ void MainWindow::loadSignals()
     }
 
     QList<VCDSignal> signalsToLoad;
-    QList<VCDSignal> allSignals = vcdParser->getSignals();
 
     int foundCount = 0;
     int missingCount = 0;
@@ -1654,16 +2091,12 @@ void MainWindow::loadSignals()
         QString fullName = signalObj["fullName"].toString();
 
         // Find the signal in the current VCD file
-        bool found = false;
-        for (const VCDSignal &signal : allSignals)
+        SignalHandle handle = vcdParser->findSignal(fullName);
+        bool found = handle != InvalidSignalHandle;
+        if (found)
         {
-            if (signal.fullName == fullName)
-            {
-                signalsToLoad.append(signal);
-                found = true;
-                foundCount++;
-                break;
-            }
+            signalsToLoad.append(vcdParser->getSignal(handle));
+            foundCount++;
         }
 
         if (!found)
@@ -1802,6 +2235,8 @@ void MainWindow::refreshVcd()
     int currentSignalHeight = waveformWidget->getSignalHeight();
     int currentLineWidth = waveformWidget->getLineWidth();
     WaveformWidget::BusFormat currentBusFormat = waveformWidget->getBusDisplayFormat();
+    int currentWindowStart = vcdParser->hasTimeWindow() ? vcdParser->getWindowStart() : -1;
+    int currentWindowEnd = vcdParser->hasTimeWindow() ? vcdParser->getWindowEnd() : -1;
 
     // Get current signals
     for (int i = 0; i < waveformWidget->getItemCount(); i++)
@@ -1833,7 +2268,7 @@ void MainWindow::refreshVcd()
                                                     { return vcdParser->parseHeaderOnly(currentVcdFilePath); });
 
     QFutureWatcher<bool> *watcher = new QFutureWatcher<bool>(this);
-    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, progressBar, watcher, currentSignals, currentCursorTime, currentSignalHeight, currentLineWidth, currentBusFormat]()
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, progressBar, watcher, currentSignals, currentCursorTime, currentSignalHeight, currentLineWidth, currentBusFormat, currentWindowStart, currentWindowEnd]()
             {
         bool success = watcher->result();
         
@@ -1846,6 +2281,11 @@ void MainWindow::refreshVcd()
         watcher->deleteLater();
         
         if (success) {
+            // Keep the same time window after reparsing the header
+            if (currentWindowEnd >= 0) {
+                vcdParser->setTimeWindow(currentWindowStart, currentWindowEnd);
+            }
+
             // Restore display settings
             waveformWidget->setSignalHeight(currentSignalHeight);
             waveformWidget->setLineWidth(currentLineWidth);
@@ -1853,21 +2293,17 @@ void MainWindow::refreshVcd()
             
             // Reload signals that still exist in the new VCD
             QList<VCDSignal> signalsToReload;
-            QList<VCDSignal> allSignals = vcdParser->getSignals();
             
             int foundCount = 0;
             int missingCount = 0;
             QStringList missingSignals;
             
             for (const VCDSignal &oldSignal : currentSignals) {
-                bool found = false;
-                for (const VCDSignal &newSignal : allSignals) {
-                    if (newSignal.fullName == oldSignal.fullName) {
-                        signalsToReload.append(newSignal);
-                        found = true;
-                        foundCount++;
-                        break;
-                    }
+                SignalHandle handle = vcdParser->findSignal(oldSignal.fullName);
+                bool found = handle != InvalidSignalHandle;
+                if (found) {
+                    signalsToReload.append(vcdParser->getSignal(handle));
+                    foundCount++;
                 }
                 
                 if (!found) {
@@ -2017,179 +2453,193 @@ void MainWindow::performValueSearch(const QString &searchValue, int searchFormat
 {
     if (!vcdParser) return;
 
+    cancelValueSearch();
     valueSearchMatches.clear();
     currentSearchMatchIndex = -1;
 
     // Get format name for status
-    QString formatName;
     switch (searchFormat) {
-    case FormatBinary: formatName = "binary"; break;
-    case FormatHex: formatName = "hex"; break;
-    case FormatDecimal: formatName = "decimal"; break;
-    case FormatOctal: formatName = "octal"; break;
-    default: formatName = "hex"; break; // DEFAULT TO HEX
+    case FormatBinary: valueSearchFormatName = "binary"; break;
+    case FormatHex: valueSearchFormatName = "hex"; break;
+    case FormatDecimal: valueSearchFormatName = "decimal"; break;
+    case FormatOctal: valueSearchFormatName = "octal"; break;
+    default: valueSearchFormatName = "hex"; break; // DEFAULT TO HEX
+    }
+
+    // NEW: Parse the search value once, not once per compared change
+    ValuePattern pattern;
+    if (!pattern.compile(searchValue, searchFormat)) {
+        statusLabel->setText(QString("Invalid search value: %1").arg(pattern.errorString()));
+        QMessageBox::warning(this, "Search Signal Value", pattern.errorString());
+        return;
     }
-    
+
     qDebug() << "=== STARTING VALUE SEARCH ===";
-    qDebug() << "Search value:" << searchValue << "Format:" << formatName;
-    
-    statusLabel->setText(QString("Searching for %1 value: %2...").arg(formatName).arg(searchValue));
-    QApplication::processEvents();
+    qDebug() << "Search value:" << searchValue << "Format:" << valueSearchFormatName;
 
     // Collect all signals from display
-    QList<QString> signalNames;
-    QMap<QString, int> signalIndexMap;
-    QMap<QString, int> signalWidthMap;
-
+    QList<ValueSearchJob> jobs;
+    QList<QString> unloaded;
+    int indexedSignals = 0;
     for (int i = 0; i < waveformWidget->getItemCount(); i++) {
         const DisplayItem *item = waveformWidget->getItem(i);
         if (item && item->type == DisplayItem::Signal) {
-            QString fullName = item->signal.signal.fullName;
-            signalNames.append(fullName);
-            signalIndexMap[fullName] = i;
-            signalWidthMap[fullName] = item->signal.signal.width;
-            qDebug() << "Signal to search:" << fullName << "Width:" << item->signal.signal.width;
+            ValueSearchJob job;
+            job.pattern = pattern;
+            job.signalName = item->signal.signal.fullName;
+            job.signalIndex = i;
+            job.width = item->signal.signal.width;
+            job.endTime = vcdParser->getEndTime();
+
+            // NEW: A known histogram answers without the change data
+            job.histogram = vcdParser->cachedValueHistogram(job.signalName);
+            if (job.histogram) {
+                indexedSignals++;
+            } else {
+                job.buildHistogram = job.width > 1 && currentStreamSource.isEmpty() &&
+                                     !vcdParser->hasValueHistogramEntry(job.signalName);
+                if (!vcdParser->isSignalLoaded(job.signalName)) {
+                    unloaded.append(job.signalName);
+                }
+            }
+            jobs.append(job);
         }
     }
 
-    if (signalNames.isEmpty()) {
+    if (jobs.isEmpty()) {
         QMessageBox::information(this, "Search Signal Value", "No signals to search.");
         return;
     }
 
-    // Search through all signals
-    int totalMatches = 0;
-    
-    for (const QString &signalName : signalNames) {
-        const auto changes = vcdParser->getValueChangesForSignal(signalName);
-        if (changes.isEmpty()) {
-            qDebug() << "No changes for signal:" << signalName;
-            continue;
+    // One pass over the file for everything not in memory, then the parser
+    // is left alone: worker threads only read their own copies of the changes
+    if (!unloaded.isEmpty()) {
+        vcdParser->loadSignalsData(unloaded);
+    }
+    for (ValueSearchJob &job : jobs) {
+        if (!job.histogram) {
+            job.changes = vcdParser->getValueChangesForSignal(job.signalName);
         }
+    }
+    qDebug() << "Value search:" << indexedSignals << "of" << jobs.size() << "signals answered from histograms";
 
-        qDebug() << "Searching signal:" << signalName << "Changes count:" << changes.size();
-        
-        int signalWidth = signalWidthMap[signalName];
-        QString prevValue = changes.first().value;
-        int prevTime = changes.first().timestamp;
-
-        // Check initial value
-        if (matchesSearchValue(prevValue, searchValue, signalWidth, searchFormat)) {
-            qDebug() << "FOUND MATCH - Initial value:" << prevValue << "at time 0";
-            ValueSearchMatch match;
-            match.signalName = signalName;
-            match.timestamp = 0; // Start time
-            match.value = prevValue;
-            match.signalIndex = signalIndexMap[signalName];
-            valueSearchMatches.append(match);
-            totalMatches++;
-        }
-
-        // Check all value changes
-        for (int i = 1; i < changes.size(); i++) {
-            const auto &change = changes[i];
-            if (matchesSearchValue(change.value, searchValue, signalWidth, searchFormat)) {
-                qDebug() << "FOUND MATCH - Value:" << change.value << "at time" << change.timestamp;
-                ValueSearchMatch match;
-                match.signalName = signalName;
-                match.timestamp = change.timestamp;
-                match.value = change.value;
-                match.signalIndex = signalIndexMap[signalName];
-                valueSearchMatches.append(match);
-                totalMatches++;
+    statusLabel->setText(QString("Searching %1 signals for %2 value: %3...")
+                         .arg(jobs.size()).arg(valueSearchFormatName).arg(searchValue));
+
+    // NEW: Signals are scanned in parallel; matches stream into the list as
+    // each signal finishes
+    valueSearchWatcher = new QFutureWatcher<ValueSearchHits>(this);
+    connect(valueSearchWatcher, &QFutureWatcher<ValueSearchHits>::resultsReadyAt,
+            this, &MainWindow::onValueSearchResults);
+    connect(valueSearchWatcher, &QFutureWatcher<ValueSearchHits>::finished,
+            this, &MainWindow::onValueSearchFinished);
+    valueSearchWatcher->setFuture(QtConcurrent::mapped(jobs, &MainWindow::scanValueSearchJob));
+}
+
+// Runs on the thread pool
+MainWindow::ValueSearchHits MainWindow::scanValueSearchJob(const ValueSearchJob &job)
+{
+    ValueSearchHits hits;
+    hits.signalName = job.signalName;
+
+    ValueSearchMatch match;
+    match.signalName = job.signalName;
+    match.signalIndex = job.signalIndex;
+
+    // Each distinct value is tested once; its times come from the histogram
+    if (job.histogram) {
+        for (const QString &value : job.histogram->values()) {
+            if (!job.pattern.matches(value, job.width)) {
+                continue;
+            }
+            match.value = value;
+            for (int time : job.histogram->times(value)) {
+                match.timestamp = time;
+                hits.matches.append(match);
             }
-            prevValue = change.value;
         }
+        std::sort(hits.matches.begin(), hits.matches.end(),
+                  [](const ValueSearchMatch &a, const ValueSearchMatch &b) { return a.timestamp < b.timestamp; });
+        return hits;
     }
 
-    qDebug() << "Total matches found:" << totalMatches;
-
-    if (valueSearchMatches.isEmpty()) {
-        statusLabel->setText(QString("Value '%1' not found").arg(searchValue));
-        QMessageBox::information(this, "Search Signal Value", 
-                               QString("Value '%1' (%2 format) not found in any signal.")
-                               .arg(searchValue).arg(formatName));
-        return;
+    for (int i : job.pattern.scan(job.changes, job.width)) {
+        match.timestamp = i == 0 ? 0 : job.changes[i].timestamp; // Initial value counts from time 0
+        match.value = job.changes[i].value;
+        hits.matches.append(match);
     }
 
-    // Sort matches by timestamp
-    std::sort(valueSearchMatches.begin(), valueSearchMatches.end(),
-              [](const ValueSearchMatch &a, const ValueSearchMatch &b) {
-                  return a.timestamp < b.timestamp;
-              });
-
-    statusLabel->setText(QString("Found %1 matches for '%2' (%3 format)").arg(totalMatches).arg(searchValue).arg(formatName));
-    
-    // Jump to first match
-    currentSearchMatchIndex = 0;
-    highlightSearchMatch(currentSearchMatchIndex);
+    if (job.buildHistogram) {
+        hits.histogram = ValueHistogram::build(job.changes, job.endTime);
+        hits.builtHistogram = true;
+    }
+    return hits;
 }
 
-unsigned long long MainWindow::convertToNumeric(const QString &value, int format) const
+void MainWindow::cancelValueSearch()
 {
-    if (value.isEmpty() || value.toLower() == "x" || value.toLower() == "z") {
-        return 0; // Can't convert special values
+    if (!valueSearchWatcher) {
+        return;
     }
 
-    QString processedValue = value.toLower();
-    int base = 2;
+    valueSearchWatcher->disconnect(this);
+    valueSearchWatcher->cancel();
+    valueSearchWatcher->waitForFinished();
+    valueSearchWatcher->deleteLater();
+    valueSearchWatcher = nullptr;
+}
 
-    // Determine base based on format or auto-detect
-    if (format != -1) {
-        switch (format) {
-        case FormatBinary: base = 2; break;
-        case FormatHex: base = 16; break;
-        case FormatDecimal: base = 10; break;
-        case FormatOctal: base = 8; break;
-        default: base = 2; break;
+void MainWindow::onValueSearchResults(int begin, int end)
+{
+    auto byTime = [](const ValueSearchMatch &a, const ValueSearchMatch &b) {
+        return a.timestamp < b.timestamp;
+    };
+
+    // Each signal's hits are already in time order: merge them in so the
+    // list stays sorted while the rest of the scan runs
+    for (int r = begin; r < end; r++) {
+        const ValueSearchHits hits = valueSearchWatcher->resultAt(r);
+        if (hits.builtHistogram) {
+            vcdParser->storeValueHistogram(hits.signalName, hits.histogram);
         }
-        
-        // Remove prefixes if present
-        if (base == 16 && processedValue.startsWith("0x")) {
-            processedValue = processedValue.mid(2);
-        } else if (base == 8 && processedValue.startsWith("0o")) {
-            processedValue = processedValue.mid(2);
-        } else if (base == 2 && processedValue.startsWith("b")) {
-            processedValue = processedValue.mid(1);
-        } else if (base == 10 && processedValue.startsWith("d")) {
-            processedValue = processedValue.mid(1);
+        if (hits.matches.isEmpty()) {
+            continue;
         }
-    } else {
-        // Auto-detect format for signal values
-        if (processedValue.startsWith("0x")) {
-            processedValue = processedValue.mid(2);
-            base = 16;
-        } else if (processedValue.startsWith("0o")) {
-            processedValue = processedValue.mid(2);
-            base = 8;
-        } else if (processedValue.startsWith("b")) {
-            processedValue = processedValue.mid(1);
-            base = 2;
-        } else if (processedValue.startsWith("d")) {
-            processedValue = processedValue.mid(1);
-            base = 10;
-        } else if (QRegularExpression("^[01]+$").match(processedValue).hasMatch()) {
-            base = 2;
-        } else if (QRegularExpression("^[0-7]+$").match(processedValue).hasMatch()) {
-            base = 8;
-        } else if (QRegularExpression("^[0-9a-f]+$").match(processedValue).hasMatch()) {
-            base = 16;
-        } else if (QRegularExpression("^\\d+$").match(processedValue).hasMatch()) {
-            base = 10;
-        } else {
-            base = 2; // Default fallback
+
+        const int middle = valueSearchMatches.size();
+        for (const ValueSearchMatch &match : hits.matches) {
+            valueSearchMatches.append(match);
         }
+        std::inplace_merge(valueSearchMatches.begin(), valueSearchMatches.begin() + middle,
+                           valueSearchMatches.end(), byTime);
     }
 
-    bool ok;
-    unsigned long long numericValue = processedValue.toULongLong(&ok, base);
-    
-    if (!ok) {
-        qDebug() << "Numeric conversion failed for:" << processedValue << "base:" << base;
-        return 0;
+    statusLabel->setText(QString("Searching for '%1'... %2 matches in %3/%4 signals")
+                         .arg(lastSearchValue).arg(valueSearchMatches.size())
+                         .arg(valueSearchWatcher->progressValue()).arg(valueSearchWatcher->progressMaximum()));
+}
+
+void MainWindow::onValueSearchFinished()
+{
+    valueSearchWatcher->deleteLater();
+    valueSearchWatcher = nullptr;
+
+    qDebug() << "Total matches found:" << valueSearchMatches.size();
+
+    if (valueSearchMatches.isEmpty()) {
+        statusLabel->setText(QString("Value '%1' not found").arg(lastSearchValue));
+        QMessageBox::information(this, "Search Signal Value", 
+                               QString("Value '%1' (%2 format) not found in any signal.")
+                               .arg(lastSearchValue).arg(valueSearchFormatName));
+        return;
     }
 
-    return numericValue;
+    statusLabel->setText(QString("Found %1 matches for '%2' (%3 format)")
+                         .arg(valueSearchMatches.size()).arg(lastSearchValue).arg(valueSearchFormatName));
+    
+    // Jump to first match
+    currentSearchMatchIndex = 0;
+    highlightSearchMatch(currentSearchMatchIndex);
 }
 
 QString MainWindow::convertToBinaryStrict(const QString &value, int signalWidth, int format) const
@@ -2267,55 +2717,6 @@ QString MainWindow::convertToBinaryStrict(const QString &value, int signalWidth,
     return binary;
 }
 
-bool MainWindow::matchesSearchValue(const QString &signalValue, const QString &searchValue, int signalWidth, int searchFormat) const
-{
-    if (searchValue.isEmpty()) return false;
-
-    QString normalizedSearch = searchValue.trimmed().toLower();
-    QString normalizedSignal = signalValue.toLower();
-
-    qDebug() << "Matching - Signal:" << signalValue << "Search:" << searchValue << "Width:" << signalWidth;
-
-    // First try direct string comparison (case insensitive)
-    // This handles exact matches and special values
-    if (normalizedSignal == normalizedSearch) {
-        qDebug() << "Direct string match found!";
-        return true;
-    }
-
-    // Handle special values (x, z)
-    if (normalizedSearch == "x" || normalizedSearch == "z") {
-        return normalizedSignal == normalizedSearch;
-    }
-
-    // NEW: Convert search value to see what numeric value it represents
-    unsigned long long searchNumeric = convertToNumeric(normalizedSearch, searchFormat);
-    qDebug() << "Search represents numeric value:" << searchNumeric;
-
-    // Convert signal value to numeric
-    unsigned long long signalNumeric = convertToNumeric(normalizedSignal, -1); // Auto-detect format
-    qDebug() << "Signal represents numeric value:" << signalNumeric;
-
-    // NEW: Critical fix - Handle signal width properly!
-    // For the match to be valid, the search value must fit within the signal width
-    unsigned long long maxValueForWidth = (1ULL << signalWidth) - 1;
-    
-    qDebug() << "Max value for width" << signalWidth << ":" << maxValueForWidth;
-    
-    // If search value is too large for this signal width, it can't match
-    if (searchNumeric > maxValueForWidth) {
-        qDebug() << "Search value too large for signal width - no match";
-        return false;
-    }
-
-    // Now compare the numeric values
-    bool match = (searchNumeric == signalNumeric);
-    qDebug() << "Numeric match result:" << match;
-    
-    return match;
-}
-
-
 QString MainWindow::convertToBinary(const QString &value, int signalWidth) const
 {
     if (value.isEmpty() || value.toLower() == "x" || value.toLower() == "z") {
@@ -2386,6 +2787,569 @@ QString MainWindow::convertToBinary(const QString &value, int signalWidth) const
     return binary;
 }
 
+void MainWindow::showValueFrequencies()
+{
+    const DisplayItem *item = waveformWidget->getItem(waveformWidget->getSelectedSignal());
+    if (!item || item->type != DisplayItem::Signal || item->signal.signal.width <= 1) {
+        QMessageBox::information(this, "Value Frequencies", "Select a bus first.");
+        return;
+    }
+
+    const QString fullName = item->signal.signal.fullName;
+    if (!vcdParser->hasValueHistogramEntry(fullName)) {
+        vcdParser->loadSignalsData({fullName}); // Built from the data, which may have been evicted
+    }
+    QSharedPointer<const ValueHistogram> histogram = vcdParser->getValueHistogram(fullName);
+    if (!histogram) {
+        QMessageBox::information(this, "Value Frequencies",
+                                 vcdParser->hasValueHistogramEntry(fullName)
+                                     ? QString("%1 takes more than %2 distinct values.")
+                                           .arg(fullName).arg(ValueHistogram::MAX_DISTINCT_VALUES)
+                                     : QString("The data of %1 is still loading.").arg(fullName));
+        return;
+    }
+
+    QDialog dialog(this);
+    dialog.setWindowTitle(QString("Value Frequencies - %1").arg(fullName));
+    dialog.resize(520, 420);
+    QVBoxLayout *layout = new QVBoxLayout(&dialog);
+
+    const QStringList values = histogram->values();
+    QTableWidget *table = new QTableWidget(values.size(), 4, &dialog);
+    table->setHorizontalHeaderLabels({"Value", "Occurrences", "Time", "% of Time"});
+    table->verticalHeader()->setVisible(false);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+
+    const double total = qMax<qint64>(1, histogram->totalDuration());
+    for (int row = 0; row < values.size(); row++) {
+        const QString &value = values[row];
+        QTableWidgetItem *occurrences = new QTableWidgetItem;
+        occurrences->setData(Qt::DisplayRole, histogram->occurrences(value));
+        QTableWidgetItem *duration = new QTableWidgetItem;
+        duration->setData(Qt::DisplayRole, histogram->duration(value));
+        QTableWidgetItem *share = new QTableWidgetItem;
+        share->setData(Qt::DisplayRole, qRound(1000.0 * histogram->duration(value) / total) / 10.0);
+
+        table->setItem(row, 0, new QTableWidgetItem(value));
+        table->setItem(row, 1, occurrences);
+        table->setItem(row, 2, duration);
+        table->setItem(row, 3, share);
+    }
+    table->setSortingEnabled(true);
+    table->sortByColumn(1, Qt::DescendingOrder);
+    table->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Close);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+
+    layout->addWidget(new QLabel(QString("%1 distinct values").arg(values.size())));
+    layout->addWidget(table);
+    layout->addWidget(buttons);
+    dialog.exec();
+}
+
+void MainWindow::loadGoldenVcd()
+{
+    const QString filename = QFileDialog::getOpenFileName(
+        this, "Open Golden VCD File", QFileInfo(currentVcdFilePath).absolutePath(), "VCD Files (*.vcd)");
+    if (filename.isEmpty()) {
+        return;
+    }
+
+    clearComparison();
+    if (!goldenParser) {
+        goldenParser = new VCDParser(this);
+    }
+
+    loadGoldenAction->setEnabled(false);
+    compareGoldenAction->setEnabled(false);
+    statusLabel->setText(QString("Loading golden VCD %1...").arg(QFileInfo(filename).fileName()));
+
+    // Only the header is read now; signal data comes in as comparisons need it
+    VCDParser *parser = goldenParser;
+    QFutureWatcher<bool> *watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher, filename]() {
+        watcher->deleteLater();
+        loadGoldenAction->setEnabled(true);
+
+        if (!watcher->result()) {
+            goldenFilePath.clear();
+            QMessageBox::critical(this, "Error", "Failed to parse golden VCD file: " + goldenParser->getError());
+            statusLabel->setText("Ready");
+            return;
+        }
+
+        goldenFilePath = filename;
+        compareGoldenAction->setEnabled(true);
+        statusLabel->setText(QString("Golden: %1 (%2 signals)")
+                             .arg(QFileInfo(filename).fileName()).arg(goldenParser->getSignalCount()));
+    });
+    watcher->setFuture(QtConcurrent::run([parser, filename]() { return parser->parseHeaderOnly(filename); }));
+}
+
+void MainWindow::compareSelectedSignals()
+{
+    QList<int> indices = waveformWidget->getSelectedItemIndices();
+    std::sort(indices.begin(), indices.end());
+
+    QList<QString> names;
+    for (int index : indices) {
+        const DisplayItem *item = waveformWidget->getItem(index);
+        if (item && item->type == DisplayItem::Signal) {
+            names.append(item->signal.signal.fullName);
+        }
+    }
+    if (names.size() != 2) {
+        QMessageBox::information(this, "Compare Signals", "Select exactly two signals to compare.");
+        return;
+    }
+
+    vcdParser->loadSignalsData(names);
+
+    DiffJob job;
+    job.leftName = names[0];
+    job.rightName = names[1];
+    job.left = vcdParser->getValueChangesForSignal(job.leftName);
+    job.right = vcdParser->getValueChangesForSignal(job.rightName);
+    job.endTime = vcdParser->getEndTime();
+    startComparison({job}, QString("%1 vs %2").arg(job.leftName, job.rightName));
+}
+
+void MainWindow::compareAgainstGolden()
+{
+    if (!goldenParser || goldenFilePath.isEmpty()) {
+        QMessageBox::information(this, "Compare Against Golden", "Load a golden VCD first.");
+        return;
+    }
+
+    // The selected signals, or every displayed one when nothing is selected
+    QList<int> indices = waveformWidget->getSelectedItemIndices();
+    if (indices.isEmpty()) {
+        for (int i = 0; i < waveformWidget->getItemCount(); i++) {
+            indices.append(i);
+        }
+    }
+    std::sort(indices.begin(), indices.end());
+
+    QList<QString> names;
+    QList<QString> goldenNames;
+    for (int index : indices) {
+        const DisplayItem *item = waveformWidget->getItem(index);
+        if (!item || item->type != DisplayItem::Signal) {
+            continue;
+        }
+        const QString &fullName = item->signal.signal.fullName;
+        names.append(fullName);
+        if (goldenParser->findSignal(fullName) != InvalidSignalHandle) {
+            goldenNames.append(fullName);
+        }
+    }
+    if (names.isEmpty()) {
+        QMessageBox::information(this, "Compare Against Golden", "No signals to compare.");
+        return;
+    }
+
+    // One pass over each file, then both parsers are left alone
+    statusLabel->setText(QString("Loading %1 signals from both dumps...").arg(names.size()));
+    QApplication::processEvents();
+    vcdParser->loadSignalsData(names);
+    goldenParser->loadSignalsData(goldenNames);
+
+    const int endTime = qMax(vcdParser->getEndTime(), goldenParser->getEndTime());
+    QList<DiffJob> jobs;
+    for (const QString &fullName : names) {
+        DiffJob job;
+        job.leftName = fullName;
+        job.rightName = fullName; // The same signal in the golden dump
+        job.endTime = endTime;
+        job.missing = !goldenNames.contains(fullName);
+        if (!job.missing) {
+            job.left = vcdParser->getValueChangesForSignal(fullName);
+            job.right = goldenParser->getValueChangesForSignal(fullName);
+        }
+        jobs.append(job);
+    }
+    startComparison(jobs, QString("against %1").arg(QFileInfo(goldenFilePath).fileName()));
+}
+
+void MainWindow::startComparison(const QList<DiffJob> &jobs, const QString &description)
+{
+    clearComparison();
+    diffDescription = description;
+    statusLabel->setText(QString("Comparing %1 signal(s) %2...").arg(jobs.size()).arg(description));
+
+    diffWatcher = new QFutureWatcher<SignalDiff::Result>(this);
+    connect(diffWatcher, &QFutureWatcher<SignalDiff::Result>::finished,
+            this, &MainWindow::onComparisonFinished);
+    diffWatcher->setFuture(QtConcurrent::mapped(jobs, &MainWindow::runDiffJob));
+}
+
+// Runs on the thread pool
+SignalDiff::Result MainWindow::runDiffJob(const DiffJob &job)
+{
+    SignalDiff::Result result;
+    result.leftName = job.leftName;
+    result.rightName = job.rightName;
+    result.missing = job.missing;
+    if (job.missing) {
+        return result;
+    }
+
+    result.mismatches = SignalDiff::compare(job.left, job.right, job.endTime);
+    for (const SignalDiff::Interval &interval : result.mismatches) {
+        result.mismatchTime += interval.end - interval.start;
+    }
+    if (!result.mismatches.isEmpty()) {
+        result.firstDivergence = result.mismatches.first().start;
+    }
+    return result;
+}
+
+void MainWindow::cancelComparison()
+{
+    if (!diffWatcher) {
+        return;
+    }
+
+    diffWatcher->disconnect(this);
+    diffWatcher->cancel();
+    diffWatcher->waitForFinished();
+    diffWatcher->deleteLater();
+    diffWatcher = nullptr;
+}
+
+void MainWindow::clearComparison()
+{
+    cancelComparison();
+    waveformWidget->clearMismatchOverlays();
+}
+
+void MainWindow::onComparisonFinished()
+{
+    QVector<SignalDiff::Result> results;
+    for (const SignalDiff::Result &result : diffWatcher->future().results()) {
+        results.append(result);
+    }
+    diffWatcher->deleteLater();
+    diffWatcher = nullptr;
+
+    // Earliest divergence first, then signals that agree, then missing ones
+    std::stable_sort(results.begin(), results.end(), [](const SignalDiff::Result &a, const SignalDiff::Result &b) {
+        auto rank = [](const SignalDiff::Result &r) { return r.missing ? 2 : r.firstDivergence < 0 ? 1 : 0; };
+        if (rank(a) != rank(b)) {
+            return rank(a) < rank(b);
+        }
+        return a.firstDivergence < b.firstDivergence;
+    });
+
+    int differing = 0;
+    int missing = 0;
+    for (const SignalDiff::Result &result : results) {
+        if (result.missing) {
+            missing++;
+        } else if (result.firstDivergence >= 0) {
+            differing++;
+            waveformWidget->setMismatchOverlay(result.leftName, result.mismatches);
+            waveformWidget->setMismatchOverlay(result.rightName, result.mismatches); // Same row against golden
+        }
+    }
+
+    QString summary = QString("%1 of %2 signal(s) differ %3").arg(differing).arg(results.size()).arg(diffDescription);
+    if (missing > 0) {
+        summary += QString(", %1 missing").arg(missing);
+    }
+    if (differing > 0) {
+        summary += QString("; first divergence at %1 in %2").arg(results.first().firstDivergence).arg(results.first().leftName);
+        waveformWidget->navigateToTime(results.first().firstDivergence);
+    }
+    statusLabel->setText(summary);
+    qDebug() << "Comparison:" << summary;
+
+    if (results.size() > 1) {
+        showComparisonResults(results);
+    }
+}
+
+void MainWindow::showComparisonResults(const QVector<SignalDiff::Result> &results)
+{
+    QDialog dialog(this);
+    dialog.setWindowTitle(QString("Comparison %1").arg(diffDescription));
+    dialog.resize(640, 420);
+    QVBoxLayout *layout = new QVBoxLayout(&dialog);
+
+    QTableWidget *table = new QTableWidget(results.size(), 4, &dialog);
+    table->setHorizontalHeaderLabels({"Signal", "First Divergence", "Mismatches", "Mismatch Time"});
+    table->verticalHeader()->setVisible(false);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+
+    for (int row = 0; row < results.size(); row++) {
+        const SignalDiff::Result &result = results[row];
+        QTableWidgetItem *name = new QTableWidgetItem(result.leftName);
+        name->setData(Qt::UserRole, result.firstDivergence);
+        table->setItem(row, 0, name);
+
+        if (result.missing) {
+            table->setItem(row, 1, new QTableWidgetItem("not in golden"));
+            continue;
+        }
+        table->setItem(row, 1, new QTableWidgetItem(result.firstDivergence < 0 ? QString("identical")
+                                                                               : QString::number(result.firstDivergence)));
+        QTableWidgetItem *count = new QTableWidgetItem;
+        count->setData(Qt::DisplayRole, result.mismatches.size());
+        QTableWidgetItem *duration = new QTableWidgetItem;
+        duration->setData(Qt::DisplayRole, result.mismatchTime);
+        table->setItem(row, 2, count);
+        table->setItem(row, 3, duration);
+    }
+    table->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+
+    // Double-click jumps to where that signal first diverges
+    connect(table, &QTableWidget::cellDoubleClicked, &dialog, [this, table, &dialog](int row, int) {
+        const int time = table->item(row, 0)->data(Qt::UserRole).toInt();
+        if (time >= 0) {
+            waveformWidget->navigateToTime(time);
+            dialog.accept();
+        }
+    });
+
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Close);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+
+    layout->addWidget(new QLabel("Double-click a signal to go to its first divergence."));
+    layout->addWidget(table);
+    layout->addWidget(buttons);
+    dialog.exec();
+}
+
+void MainWindow::showActivityStatistics()
+{
+    if (!vcdParser || vcdParser->getSignalCount() == 0) {
+        QMessageBox::information(this, "Activity Statistics", "Open a VCD file first.");
+        return;
+    }
+
+    // Default to the scope of the selected row
+    QString defaultScope;
+    const DisplayItem *selected = waveformWidget->getItem(waveformWidget->getSelectedSignal());
+    if (selected && selected->type == DisplayItem::Signal) {
+        defaultScope = selected->signal.signal.scope;
+    }
+
+    QDialog dialog(this);
+    dialog.setWindowTitle("Activity Statistics");
+    QFormLayout *form = new QFormLayout(&dialog);
+    QLineEdit *scopeEdit = new QLineEdit(defaultScope, &dialog);
+    scopeEdit->setPlaceholderText("Empty: the displayed signals");
+    QSpinBox *glitchSpin = new QSpinBox(&dialog);
+    glitchSpin->setRange(1, INT_MAX);
+    glitchSpin->setValue(activityGlitchWidth);
+    form->addRow("Scope (with sub-scopes):", scopeEdit);
+    form->addRow("Glitch: pulse shorter than", glitchSpin);
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+    connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    form->addRow(buttons);
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
+
+    cancelActivityAnalysis();
+    activityGlitchWidth = glitchSpin->value();
+    activityScope = scopeEdit->text().trimmed();
+
+    if (activityScope.isEmpty()) {
+        for (int i = 0; i < waveformWidget->getItemCount(); i++) {
+            const DisplayItem *item = waveformWidget->getItem(i);
+            if (item && item->type == DisplayItem::Signal) {
+                activityNames.append(item->signal.signal.fullName);
+                activityWidths.append(item->signal.signal.width);
+            }
+        }
+    } else {
+        // The scope's own signals and its whole subtree are one range
+        int scope = -1;
+        for (int s = 1; s < vcdParser->getScopeCount() && scope < 0; s++) {
+            if (vcdParser->getScopePath(s) == activityScope) {
+                scope = s;
+            }
+        }
+        if (scope < 0) {
+            QMessageBox::warning(this, "Activity Statistics", QString("No scope named %1.").arg(activityScope));
+            return;
+        }
+        const VCDScopeTree &tree = vcdParser->getScopeTree();
+        for (int i = tree.signalBegin[scope]; i < tree.subtreeEnd[scope]; i++) {
+            const SignalHandle handle = tree.signalOrder[i];
+            activityNames.append(vcdParser->getFullName(handle));
+            activityWidths.append(vcdParser->getSignalWidth(handle));
+        }
+    }
+
+    if (activityNames.isEmpty()) {
+        QMessageBox::information(this, "Activity Statistics", "No signals to analyze.");
+        return;
+    }
+
+    qDebug() << "Activity statistics for" << activityNames.size() << "signals, glitch width" << activityGlitchWidth;
+    startActivityBatch();
+}
+
+void MainWindow::startActivityBatch()
+{
+    static const int ACTIVITY_BATCH_SIGNALS = 1024;
+
+    const int end = qMin(activityQueuePos + ACTIVITY_BATCH_SIGNALS, activityNames.size());
+    const QList<QString> batch = activityNames.mid(activityQueuePos, end - activityQueuePos);
+    statusLabel->setText(QString("Activity statistics: loading signals %1-%2 of %3...")
+                         .arg(activityQueuePos + 1).arg(end).arg(activityNames.size()));
+    QApplication::processEvents();
+
+    // One pass over the file for the batch; the jobs hold their own
+    // references to the data, so the cache may evict it meanwhile
+    vcdParser->loadSignalsData(batch);
+    QList<ActivityJob> jobs;
+    for (int i = activityQueuePos; i < end; i++) {
+        ActivityJob job;
+        job.fullName = activityNames[i];
+        job.width = activityWidths[i];
+        job.endTime = vcdParser->getEndTime();
+        job.glitchWidth = activityGlitchWidth;
+        job.changes = vcdParser->getValueChangesForSignal(job.fullName);
+        jobs.append(job);
+    }
+    activityQueuePos = end;
+
+    activityWatcher = new QFutureWatcher<SignalActivity>(this);
+    connect(activityWatcher, &QFutureWatcher<SignalActivity>::finished,
+            this, &MainWindow::onActivityBatchFinished);
+    activityWatcher->setFuture(QtConcurrent::mapped(jobs, &MainWindow::runActivityJob));
+}
+
+// Runs on the thread pool
+SignalActivity MainWindow::runActivityJob(const ActivityJob &job)
+{
+    return ActivityStats::analyze(job.fullName, job.width, job.changes, job.endTime, job.glitchWidth);
+}
+
+void MainWindow::onActivityBatchFinished()
+{
+    for (const SignalActivity &activity : activityWatcher->future().results()) {
+        activityResults.append(activity);
+    }
+    activityWatcher->deleteLater();
+    activityWatcher = nullptr;
+
+    if (activityQueuePos < activityNames.size()) {
+        startActivityBatch();
+        return;
+    }
+
+    const QVector<SignalActivity> results = activityResults;
+    cancelActivityAnalysis(); // Done with the queue
+    statusLabel->setText(QString("Activity statistics for %1 signals").arg(results.size()));
+    showActivityResults(results);
+}
+
+void MainWindow::cancelActivityAnalysis()
+{
+    if (activityWatcher) {
+        activityWatcher->disconnect(this);
+        activityWatcher->cancel();
+        activityWatcher->waitForFinished();
+        activityWatcher->deleteLater();
+        activityWatcher = nullptr;
+    }
+    activityNames.clear();
+    activityWidths.clear();
+    activityResults.clear();
+    activityQueuePos = 0;
+}
+
+void MainWindow::showActivityResults(const QVector<SignalActivity> &results)
+{
+    QDialog dialog(this);
+    dialog.setWindowTitle(QString("Activity Statistics - %1").arg(activityScope.isEmpty() ? QString("displayed signals")
+                                                                                          : activityScope));
+    dialog.resize(760, 520);
+    QVBoxLayout *layout = new QVBoxLayout(&dialog);
+
+    QTableWidget *table = new QTableWidget(results.size(), 6, &dialog);
+    table->setHorizontalHeaderLabels({"Signal", "Width", "Toggles", "Duty %", "X/Z Time",
+                                      QString("Glitches (< %1)").arg(activityGlitchWidth)});
+    table->verticalHeader()->setVisible(false);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+
+    auto number = [](const QVariant &value) {
+        QTableWidgetItem *item = new QTableWidgetItem;
+        item->setData(Qt::DisplayRole, value);
+        return item;
+    };
+    for (int row = 0; row < results.size(); row++) {
+        const SignalActivity &activity = results[row];
+        const double duty = activity.dutyCycle();
+        table->setItem(row, 0, new QTableWidgetItem(activity.fullName));
+        table->setItem(row, 1, number(activity.width));
+        table->setItem(row, 2, number(activity.toggles));
+        table->setItem(row, 3, duty < 0 ? new QTableWidgetItem : number(qRound(1000.0 * duty) / 10.0));
+        table->setItem(row, 4, number(activity.unknownTime));
+        table->setItem(row, 5, number(activity.glitches));
+    }
+    table->setSortingEnabled(true);
+    table->sortByColumn(2, Qt::DescendingOrder);
+    table->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+
+    // Toggle counts by name, for ordering the view
+    QHash<QString, int> toggles;
+    for (const SignalActivity &activity : results) {
+        toggles.insert(activity.fullName, activity.toggles);
+    }
+
+    QPushButton *addButton = new QPushButton("Add Selected to View", &dialog);
+    connect(addButton, &QPushButton::clicked, &dialog, [this, table]() {
+        QList<VCDSignal> signalsToAdd;
+        for (const QModelIndex &index : table->selectionModel()->selectedRows(0)) {
+            const SignalHandle handle = vcdParser->findSignal(index.data().toString());
+            if (handle != InvalidSignalHandle) {
+                signalsToAdd.append(vcdParser->getSignal(handle));
+            }
+        }
+        if (!signalsToAdd.isEmpty()) {
+            addSignalsToView(signalsToAdd);
+            updateSaveLoadActions();
+        }
+    });
+
+    QPushButton *sortButton = new QPushButton("Sort View by Activity", &dialog);
+    connect(sortButton, &QPushButton::clicked, &dialog, [this, toggles]() {
+        QList<VCDSignal> displayed;
+        for (int i = 0; i < waveformWidget->getItemCount(); i++) {
+            const DisplayItem *item = waveformWidget->getItem(i);
+            if (item && item->type == DisplayItem::Signal) {
+                displayed.append(item->signal.signal);
+            }
+        }
+        // Most toggles first; signals outside the analysis keep their order at the end
+        std::stable_sort(displayed.begin(), displayed.end(), [&toggles](const VCDSignal &a, const VCDSignal &b) {
+            return toggles.value(a.fullName, -1) > toggles.value(b.fullName, -1);
+        });
+        waveformWidget->setVisibleSignals(displayed);
+    });
+
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Close);
+    buttons->addButton(addButton, QDialogButtonBox::ActionRole);
+    buttons->addButton(sortButton, QDialogButtonBox::ActionRole);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+
+    layout->addWidget(new QLabel(QString("%1 signals, pulses shorter than %2 count as glitches")
+                                     .arg(results.size()).arg(activityGlitchWidth)));
+    layout->addWidget(table);
+    layout->addWidget(buttons);
+    dialog.exec();
+}
+
 void MainWindow::highlightSearchMatch(int matchIndex)
 {
     if (matchIndex < 0 || matchIndex >= valueSearchMatches.size()) {
@@ -2417,6 +3381,7 @@ void MainWindow::highlightSearchMatch(int matchIndex)
 
 void MainWindow::clearValueSearch()
 {
+    cancelValueSearch();
     valueSearchMatches.clear();
     currentSearchMatchIndex = -1;
     lastSearchValue.clear();
@@ -2427,6 +3392,10 @@ void MainWindow::clearValueSearch()
 
 void MainWindow::findNextValue()
 {
+    if (valueSearchWatcher && valueSearchMatches.isEmpty()) {
+        return; // Still searching, nothing found yet
+    }
+
     if (valueSearchMatches.isEmpty()) {
         if (!lastSearchValue.isEmpty()) {
             performValueSearch(lastSearchValue, lastSearchFormat);
@@ -2447,6 +3416,10 @@ void MainWindow::findNextValue()
 
 void MainWindow::findPreviousValue()
 {
+    if (valueSearchWatcher && valueSearchMatches.isEmpty()) {
+        return; // Still searching, nothing found yet
+    }
+
     if (valueSearchMatches.isEmpty()) {
         if (!lastSearchValue.isEmpty()) {
             performValueSearch(lastSearchValue, lastSearchFormat);
@@ -2478,7 +3451,7 @@ ValueSearchDialog::ValueSearchDialog(QWidget *parent)
     // Value input
     QLabel *valueLabel = new QLabel("Value to search for:");
     valueEdit = new QLineEdit();
-    valueEdit->setPlaceholderText("Enter value (e.g., 0xA, 1010, 10, x, z)");
+    valueEdit->setPlaceholderText("Enter value (e.g., 0xA, DEAD_??EF, >= 8000_0000 && < 9000_0000)");
     
     // Format selection
     QGroupBox *formatGroupBox = new QGroupBox("Number Format");
@@ -2512,7 +3485,10 @@ ValueSearchDialog::ValueSearchDialog(QWidget *parent)
         "• Binary: 1010, b1010\n"
         "• Decimal: 10, d10\n"
         "• Octal: 0o12, 12\n"
-        "• Special: x, z, X, Z"
+        "• Special: x, z, X, Z\n"
+        "• Wildcards: DEAD_??EF, 10?1 ('?' skips a digit)\n"
+        "• Masks: 80/C0 (compare the bits set after '/')\n"
+        "• Ranges: >= 8000_0000 && < 9000_0000 (also ==, !=, <=, >)"
     );
     examplesLabel->setStyleSheet("color: gray; font-size: 9pt;");
     
@@ -17,11 +17,14 @@
 #include <QListWidgetItem>
 #include <QDialog>
 #include <QDialogButtonBox>
+#include <functional>
 #include <QKeyEvent>
 #include <QComboBox>
 #include "vcdparser.h"
 #include "waveformwidget.h"
-#include <QProcess>
+#include "valuepattern.h"
+#include "signaldiff.h"
+#include "activitystats.h"
 
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -29,6 +32,7 @@
 #include <QJsonValue>
 
 #include <QFileSystemWatcher>
+#include <QFutureWatcher>
 
 #include <QRegularExpression>
 #include <QInputDialog>
@@ -68,15 +72,18 @@ class MainWindow : public QMainWindow
     Q_OBJECT
 
 public:
-    MainWindow(QWidget *parent = nullptr);
+    MainWindow(const QString &streamSource = QString(), QWidget *parent = nullptr);
     ~MainWindow();
 
     // NEW: Make these methods public so SignalSelectionDialog can access them
     bool hasRtlDirectoryForSignalDialog();
     QString findRtlDirectoryForSignalDialog(const QString &vcdFile);
-    bool processVcdWithRtlForSignalDialog(const QString &vcdFile);
-    bool runVcdPortMapperForSignalDialog(const QString &inputVcd, const QString &outputVcd, const QString &rtlDir);
-    void showRtlDirectoryDialogForSignalDialog();
+    // NEW: RTL scans run in the background; done(success) is called on the
+    // GUI thread once the port directions are attached (or the scan failed)
+    void processVcdWithRtlForSignalDialog(const QString &vcdFile, std::function<void(bool)> done);
+    void applyRtlPortsForSignalDialog(const QString &rtlDir, std::function<void(bool)> done);
+    void showRtlDirectoryDialogForSignalDialog(std::function<void(bool)> done);
+    bool isRtlScanRunning() const { return rtlScanRunning; }
 
 protected:
     void keyPressEvent(QKeyEvent *event) override;
@@ -87,6 +94,13 @@ private slots:
     void findNextValue();     // NEW: Find next occurrence
     void findPreviousValue(); // NEW: Find previous occurrence
     void clearValueSearch();  // NEW: Clear value search highlights
+    void showValueFrequencies(); // NEW: Distinct values of the selected bus
+    void addDerivedSignal();     // NEW: Row computed from an expression over other signals
+    void loadGoldenVcd();          // NEW: Reference dump for comparisons
+    void compareSelectedSignals(); // NEW: Two signals of this dump
+    void compareAgainstGolden();   // NEW: Signals against the same names in the golden dump
+    void clearComparison();
+    void showActivityStatistics(); // NEW: Toggle counts, duty cycle, X/Z time and glitches
 
     void updateSaveLoadActions();
     void saveSignals();
@@ -97,10 +111,18 @@ private slots:
     void setLineThicknessThin();
     void setLineThicknessMedium();
     void openFile();
+    void openStream(); // NEW: Read VCD from a named pipe or stdin
+    void openFileTimeWindow(); // NEW: Load only [t0, t1] of a huge dump
+    void setMemoryBudget();    // NEW: Ceiling for loaded signal data
+    void addDump();            // NEW: Open another VCD beside the main one
+    void addSignalsFromDump();
+    void setDumpTimeOffset();
+    void removeDump();
     void zoomIn();
     void zoomOut();
     void zoomFit();
     void updateTimeDisplay(int time);
+    void toggleCycleView(); // NEW: Selected clock's rising edges as the time base
     void about();
     void showAddSignalsDialog();
     void removeSelectedSignals();
@@ -120,7 +142,6 @@ private slots:
     void onNextValueClicked();
 
 private:
-    unsigned long long convertToNumeric(const QString &value, int format) const;
     QString convertToBinaryStrict(const QString &value, int signalWidth, int format) const;
 
     // NEW: Value search members
@@ -128,6 +149,60 @@ private:
     QAction *findNextValueAction;
     QAction *findPreviousValueAction;
     QAction *clearValueSearchAction;
+    QAction *valueFrequenciesAction;
+    QAction *addDerivedSignalAction;
+    QAction *loadGoldenAction;
+    QAction *compareSignalsAction;
+    QAction *compareGoldenAction;
+    QAction *clearComparisonAction;
+
+    // NEW: Comparison jobs, one per signal pair, diffed on the thread pool
+    // from copies of the change data taken on the GUI thread
+    struct DiffJob
+    {
+        QString leftName;
+        QString rightName;
+        QVector<VCDValueChange> left;
+        QVector<VCDValueChange> right;
+        int endTime;
+        bool missing = false;
+    };
+    static SignalDiff::Result runDiffJob(const DiffJob &job);
+    void startComparison(const QList<DiffJob> &jobs, const QString &description);
+    void cancelComparison();
+    void onComparisonFinished();
+    void showComparisonResults(const QVector<SignalDiff::Result> &results);
+
+    VCDParser *goldenParser; // Null until a golden dump is opened
+    QString goldenFilePath;
+    QFutureWatcher<SignalDiff::Result> *diffWatcher;
+    QString diffDescription;
+
+    // NEW: Activity statistics over a scope. Signals are loaded a batch at a
+    // time through loadSignalsData() and each batch is analyzed on the
+    // thread pool while the cache is free to drop the previous one.
+    QAction *activityStatsAction;
+    struct ActivityJob
+    {
+        QString fullName;
+        int width;
+        int endTime;
+        int glitchWidth;
+        QVector<VCDValueChange> changes;
+    };
+    static SignalActivity runActivityJob(const ActivityJob &job);
+    void startActivityBatch();
+    void onActivityBatchFinished();
+    void cancelActivityAnalysis();
+    void showActivityResults(const QVector<SignalActivity> &results);
+
+    QList<QString> activityNames;
+    QVector<int> activityWidths;
+    int activityQueuePos;
+    int activityGlitchWidth;
+    QString activityScope;
+    QVector<SignalActivity> activityResults;
+    QFutureWatcher<SignalActivity> *activityWatcher;
 
     struct ValueSearchMatch
     {
@@ -137,14 +212,42 @@ private:
         int signalIndex;
     };
 
-    QList<ValueSearchMatch> valueSearchMatches;
+    // NEW: One displayed signal for a parallel value scan; the pattern is
+    // compiled once and shared read-only by every job. Buses with a value
+    // histogram are answered from it; the others are scanned, and buses
+    // without one yet get it built on the way.
+    struct ValueSearchJob
+    {
+        ValuePattern pattern;
+        QString signalName;
+        int signalIndex;
+        int width;
+        int endTime;
+        QVector<VCDValueChange> changes;
+        QSharedPointer<const ValueHistogram> histogram;
+        bool buildHistogram = false;
+    };
+    struct ValueSearchHits
+    {
+        QVector<ValueSearchMatch> matches;
+        QString signalName;
+        bool builtHistogram = false;
+        QSharedPointer<const ValueHistogram> histogram; // Null: too many values
+    };
+    static ValueSearchHits scanValueSearchJob(const ValueSearchJob &job);
+
+    QList<ValueSearchMatch> valueSearchMatches; // Sorted by time, also while results stream in
     int currentSearchMatchIndex;
     QString lastSearchValue;
     int lastSearchFormat; // NEW: Remember last search format
+    QFutureWatcher<ValueSearchHits> *valueSearchWatcher;
+    QString valueSearchFormatName;
 
     void performValueSearch(const QString &searchValue, int searchFormat); // FIXED: Added searchFormat parameter
+    void cancelValueSearch();
+    void onValueSearchResults(int begin, int end);
+    void onValueSearchFinished();
     QString convertToBinary(const QString &value, int signalWidth) const;
-    bool matchesSearchValue(const QString &signalValue, const QString &searchValue, int signalWidth, int searchFormat) const; // FIXED: Added searchFormat parameter
     void highlightSearchMatch(int matchIndex);
 
     // NEW: Search format constants
@@ -190,14 +293,14 @@ private:
     QMenu *recentMenu; // ADD THIS
 
     QString currentVcdFilePath;
+    QString currentStreamSource; // NEW: Pipe path or "-" while a stream is shown
 
     // NEW: Track RTL processing state for signal dialog
-    bool rtlProcessedForSignalDialog;
-    QString tempVcdFilePathForSignalDialog;
+    bool rtlProcessedForSignalDialog; // Port directions are attached to vcdParser's signals
+    bool rtlScanRunning;              // NEW: One background RTL scan at a time
 
     bool processVcdWithRtl(const QString &vcdFile);
     QString findRtlDirectory(const QString &vcdFile);
-    bool runVcdPortMapper(const QString &inputVcd, const QString &outputVcd, const QString &rtlDir);
 
     void showRtlDirectoryDialog();
     void createToolbarBelowMenu();
@@ -222,7 +325,8 @@ private:
     void createToolBar();
     void createStatusBar();
     void setupUI();
-    void loadVcdFile(const QString &filename);
+    void loadVcdFile(const QString &filename, int windowStart = -1, int windowEnd = -1);
+    void loadVcdStream(const QString &source);
     void loadDefaultVcdFile();
 
     void createMenuBar();
@@ -245,9 +349,29 @@ private:
 
     // Toolbar Actions
     QAction *openAction;
+    QAction *openStreamAction;
+    QAction *openTimeWindowAction;
+    QAction *memoryBudgetAction;
+    QAction *addDumpAction;
+    QAction *addDumpSignalsAction;
+    QAction *dumpOffsetAction;
+    QAction *removeDumpAction;
+
+    // NEW: Dumps open beside the main one. Their rows are linked into
+    // vcdParser (see VCDParser::addLinkedSignal) and each keeps its own store.
+    struct OpenDump
+    {
+        QString label;
+        QString filePath;
+        VCDParser *parser;
+    };
+    QList<OpenDump> extraDumps;
+    int chooseDump(const QString &title);
+    void addSignalsToView(const QList<VCDSignal> &newSignals);
     QAction *zoomInAction;
     QAction *zoomOutAction;
     QAction *zoomFitAction;
+    QAction *cycleViewAction;
     QAction *aboutAction;
 
     // Bottom controls
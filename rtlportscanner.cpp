@@ -0,0 +1,694 @@
+#include "rtlportscanner.h"
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDir>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QCryptographicHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QtConcurrent>
+#include <QElapsedTimer>
+#include <QDebug>
+
+// Bumped whenever parseSource() changes what it extracts
+static const int CACHE_FORMAT_VERSION = 1;
+
+// Reserved words that can never name a module type, an instance or a port
+static const QSet<QString> &reservedWords()
+{
+    static const QSet<QString> words = {
+        "module", "macromodule", "endmodule", "input", "output", "inout", "ref",
+        "wire", "reg", "logic", "bit", "byte", "int", "integer", "shortint", "longint",
+        "real", "realtime", "time", "string", "signed", "unsigned", "var", "const",
+        "tri", "tri0", "tri1", "triand", "trior", "wand", "wor", "uwire", "supply0", "supply1",
+        "parameter", "localparam", "defparam", "specparam", "genvar", "typedef", "struct",
+        "union", "enum", "packed", "assign", "deassign", "force", "release",
+        "always", "always_ff", "always_comb", "always_latch", "initial", "final",
+        "begin", "end", "fork", "join", "join_any", "join_none", "if", "else",
+        "case", "casex", "casez", "endcase", "default", "for", "foreach", "while", "do",
+        "repeat", "forever", "break", "continue", "return", "wait", "disable",
+        "generate", "endgenerate", "function", "endfunction", "task", "endtask",
+        "automatic", "static", "posedge", "negedge", "edge", "or", "and", "not",
+        "import", "export", "package", "endpackage", "interface", "endinterface",
+        "modport", "clocking", "endclocking", "class", "endclass", "program", "endprogram",
+        "assert", "assume", "cover", "property", "endproperty", "sequence", "endsequence",
+        "specify", "endspecify", "primitive", "endprimitive", "table", "endtable",
+        "unique", "unique0", "priority", "inside", "with", "void", "null"};
+    return words;
+}
+
+static const QSet<QString> &portTypeWords()
+{
+    static const QSet<QString> words = {
+        "wire", "reg", "logic", "bit", "byte", "int", "integer", "shortint", "longint",
+        "real", "realtime", "time", "signed", "unsigned", "var", "tri", "tri0", "tri1",
+        "triand", "trior", "wand", "wor", "uwire", "supply0", "supply1", "interconnect"};
+    return words;
+}
+
+static inline bool isIdentifierStart(QChar c)
+{
+    return c.isLetter() || c == '_';
+}
+
+static inline bool isIdentifierChar(QChar c)
+{
+    return c.isLetterOrNumber() || c == '_' || c == '$';
+}
+
+static inline bool isIdentifier(const QString &token)
+{
+    return !token.isEmpty() && isIdentifierStart(token.at(0)) && !reservedWords().contains(token);
+}
+
+// Identifiers and single punctuation characters of a source file. Comments,
+// strings, attributes and compiler directives are dropped; numbers become "0".
+static QStringList tokenize(const QString &text)
+{
+    QStringList tokens;
+    const QChar *p = text.constData();
+    const int n = text.size();
+    int i = 0;
+
+    while (i < n)
+    {
+        const QChar c = p[i];
+        if (c.isSpace())
+        {
+            i++;
+        }
+        else if (c == '/' && i + 1 < n && p[i + 1] == '/')
+        {
+            while (i < n && p[i] != '\n')
+                i++;
+        }
+        else if (c == '/' && i + 1 < n && p[i + 1] == '*')
+        {
+            int end = text.indexOf("*/", i + 2);
+            i = end < 0 ? n : end + 2;
+        }
+        else if (c == '(' && i + 2 < n && p[i + 1] == '*' && p[i + 2] != ')')
+        {
+            // (* attribute *), but not the "@(*)" sensitivity list
+            int end = text.indexOf("*)", i + 2);
+            i = end < 0 ? n : end + 2;
+        }
+        else if (c == '"')
+        {
+            for (i++; i < n && p[i] != '"'; i++)
+            {
+                if (p[i] == '\\')
+                    i++;
+            }
+            i++;
+        }
+        else if (c == '`')
+        {
+            int start = ++i;
+            while (i < n && isIdentifierChar(p[i]))
+                i++;
+            const QString directive = text.mid(start, i - start);
+            if (directive == "define" || directive == "include" || directive == "timescale")
+            {
+                // Up to the end of the line, following '\' continuations
+                while (i < n && !(p[i] == '\n' && p[i - 1] != '\\'))
+                    i++;
+            }
+            else if (directive == "ifdef" || directive == "ifndef" || directive == "elsif" || directive == "undef")
+            {
+                while (i < n && p[i].isSpace())
+                    i++;
+                while (i < n && isIdentifierChar(p[i]))
+                    i++;
+            }
+        }
+        else if (isIdentifierStart(c))
+        {
+            int start = i;
+            while (i < n && isIdentifierChar(p[i]))
+                i++;
+            tokens.append(text.mid(start, i - start));
+        }
+        else if (c == '\\')
+        {
+            // Escaped identifier, ends at white space
+            int start = ++i;
+            while (i < n && !p[i].isSpace())
+                i++;
+            tokens.append(text.mid(start, i - start));
+        }
+        else if (c.isDigit() || c == '\'')
+        {
+            for (i++; i < n && (isIdentifierChar(p[i]) || p[i] == '\''); i++)
+            {
+            }
+            tokens.append("0");
+        }
+        else
+        {
+            tokens.append(QString(c));
+            i++;
+        }
+    }
+    return tokens;
+}
+
+// Index of the token closing the bracket opened at tokens[i]
+static int skipBalanced(const QStringList &tokens, int i)
+{
+    const QString open = tokens.at(i);
+    const QString close = open == "(" ? ")" : open == "[" ? "]" : "}";
+    int depth = 0;
+    for (; i < tokens.size(); i++)
+    {
+        if (tokens.at(i) == open)
+            depth++;
+        else if (tokens.at(i) == close && --depth == 0)
+            return i;
+    }
+    return tokens.size() - 1;
+}
+
+// Reads an "input/output/inout ..." declaration starting at tokens[i], ANSI
+// list or body statement alike. Returns the index of the ';' or the ')'
+// closing the port list that ends it.
+static int parsePortDeclaration(const QStringList &tokens, int i, QHash<QString, QString> &ports)
+{
+    QString direction;
+    QString pending;
+
+    for (; i < tokens.size(); i++)
+    {
+        const QString &t = tokens.at(i);
+        if (t == "input" || t == "output" || t == "inout")
+        {
+            direction = t;
+            pending.clear();
+        }
+        else if (t == "[" || t == "{")
+        {
+            i = skipBalanced(tokens, i); // Packed or unpacked dimensions
+        }
+        else if (t == "(")
+        {
+            i = skipBalanced(tokens, i);
+        }
+        else if (t == "," || t == "=" || t == ";" || t == ")")
+        {
+            if (!pending.isEmpty() && !direction.isEmpty())
+                ports.insert(pending, direction);
+            pending.clear();
+
+            if (t == "=")
+            {
+                // Default value, up to the next port
+                for (i++; i < tokens.size(); i++)
+                {
+                    const QString &v = tokens.at(i);
+                    if (v == "(" || v == "[" || v == "{")
+                        i = skipBalanced(tokens, i);
+                    else if (v == "," || v == ";" || v == ")")
+                        break;
+                }
+                if (i < tokens.size() && tokens.at(i) != ",")
+                    return i;
+            }
+            else if (t != ",")
+            {
+                return i;
+            }
+        }
+        else if (t == ".")
+        {
+            pending.clear(); // interface.modport, the port name follows
+        }
+        else if (!portTypeWords().contains(t) && isIdentifier(t))
+        {
+            // The last identifier before a separator is the port; anything
+            // earlier was a user-defined type or package scope
+            pending = t;
+        }
+    }
+    return tokens.size() - 1;
+}
+
+static inline bool isStatementBoundary(const QString &token)
+{
+    return token == ";" || token == "begin" || token == "end" || token == "generate" || token == "endgenerate" || token == "else";
+}
+
+RtlScanCache &RtlScanCache::instance()
+{
+    static RtlScanCache cache;
+    return cache;
+}
+
+RtlScanCache::RtlScanCache()
+    : loaded(false), dirty(false)
+{
+}
+
+QString RtlScanCache::cacheFilePath() const
+{
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    QDir().mkpath(dir);
+    return dir + "/rtl_port_cache.json";
+}
+
+static QJsonObject toJson(const QHash<QString, QString> &map)
+{
+    QJsonObject object;
+    for (auto it = map.constBegin(); it != map.constEnd(); ++it)
+        object.insert(it.key(), it.value());
+    return object;
+}
+
+static QHash<QString, QString> fromJson(const QJsonObject &object)
+{
+    QHash<QString, QString> map;
+    for (auto it = object.constBegin(); it != object.constEnd(); ++it)
+        map.insert(it.key(), it.value().toString());
+    return map;
+}
+
+void RtlScanCache::load()
+{
+    loaded = true;
+
+    QFile file(cacheFilePath());
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    if (root.value("version").toInt() != CACHE_FORMAT_VERSION)
+    {
+        qDebug() << "Ignoring RTL scan cache of another format";
+        return;
+    }
+
+    QJsonObject files = root.value("files").toObject();
+    for (auto it = files.constBegin(); it != files.constEnd(); ++it)
+    {
+        QJsonObject fileObject = it.value().toObject();
+        Entry entry;
+        entry.size = qint64(fileObject.value("size").toDouble());
+        entry.modified = qint64(fileObject.value("modified").toDouble());
+        entry.hash = QByteArray::fromHex(fileObject.value("hash").toString().toLatin1());
+
+        QJsonObject moduleObjects = fileObject.value("modules").toObject();
+        for (auto m = moduleObjects.constBegin(); m != moduleObjects.constEnd(); ++m)
+        {
+            RtlModuleInfo info;
+            info.ports = fromJson(m.value().toObject().value("ports").toObject());
+            info.instances = fromJson(m.value().toObject().value("instances").toObject());
+            entry.modules.insert(m.key(), info);
+        }
+        entries.insert(it.key(), entry);
+    }
+
+    qDebug() << "RTL scan cache loaded:" << entries.size() << "files";
+}
+
+void RtlScanCache::save()
+{
+    if (!dirty)
+        return;
+
+    QJsonObject files;
+    for (auto it = entries.constBegin(); it != entries.constEnd(); ++it)
+    {
+        QJsonObject moduleObjects;
+        for (auto m = it->modules.constBegin(); m != it->modules.constEnd(); ++m)
+        {
+            QJsonObject moduleObject;
+            moduleObject.insert("ports", toJson(m->ports));
+            moduleObject.insert("instances", toJson(m->instances));
+            moduleObjects.insert(m.key(), moduleObject);
+        }
+
+        QJsonObject fileObject;
+        fileObject.insert("size", double(it->size));
+        fileObject.insert("modified", double(it->modified));
+        fileObject.insert("hash", QString::fromLatin1(it->hash.toHex()));
+        fileObject.insert("modules", moduleObjects);
+        files.insert(it.key(), fileObject);
+    }
+
+    QJsonObject root;
+    root.insert("version", CACHE_FORMAT_VERSION);
+    root.insert("files", files);
+
+    QSaveFile file(cacheFilePath());
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qDebug() << "Cannot write RTL scan cache:" << file.errorString();
+        return;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    if (file.commit())
+        dirty = false;
+}
+
+bool RtlScanCache::lookup(const QString &path, Entry *entry)
+{
+    if (!loaded)
+        load();
+
+    auto it = entries.constFind(path);
+    if (it == entries.constEnd())
+        return false;
+    *entry = it.value();
+    return true;
+}
+
+void RtlScanCache::store(const QString &path, const Entry &entry)
+{
+    if (!loaded)
+        load();
+
+    entries.insert(path, entry);
+    dirty = true;
+}
+
+void RtlScanCache::removeMissing(const QString &dir, const QSet<QString> &present)
+{
+    if (!loaded)
+        load();
+
+    const QString prefix = dir.endsWith('/') ? dir : dir + "/";
+    for (auto it = entries.begin(); it != entries.end();)
+    {
+        if (it.key().startsWith(prefix) && !present.contains(it.key()))
+        {
+            it = entries.erase(it);
+            dirty = true;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+// Runs on the thread pool
+static RtlFileJob scanRtlFile(const RtlFileJob &job)
+{
+    RtlFileJob done = job;
+    done.readable = false;
+    done.parsed = false;
+
+    QFile file(job.path);
+    if (!file.open(QIODevice::ReadOnly))
+        return done;
+    const QByteArray data = file.readAll();
+    done.readable = true;
+
+    done.result.size = job.size;
+    done.result.modified = job.modified;
+    done.result.hash = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+    if (done.result.hash == job.cachedHash)
+        return done; // Touched, not edited: the caller keeps the cached modules
+
+    done.result.modules = RtlPortScanner::parseSource(QString::fromUtf8(data));
+    done.parsed = true;
+    return done;
+}
+
+RtlPortScanner::RtlPortScanner()
+    : parsedFiles(0)
+{
+}
+
+QStringList RtlPortScanner::findRtlFiles(const QString &dir)
+{
+    QStringList files;
+    QDirIterator it(dir, QStringList() << "*.v" << "*.sv", QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext())
+        files.append(it.next());
+    return files;
+}
+
+QHash<QString, RtlModuleInfo> RtlPortScanner::parseSource(const QString &text)
+{
+    QHash<QString, RtlModuleInfo> fileModules;
+    const QStringList tokens = tokenize(text);
+    const int n = tokens.size();
+
+    RtlModuleInfo *current = nullptr;
+    QString previous = ";";
+
+    for (int i = 0; i < n; i++)
+    {
+        const QString &t = tokens.at(i);
+
+        if (t == "module" || t == "macromodule")
+        {
+            int j = i + 1;
+            if (j < n && (tokens.at(j) == "automatic" || tokens.at(j) == "static"))
+                j++;
+            if (j < n && isIdentifier(tokens.at(j)))
+            {
+                current = &fileModules[tokens.at(j)];
+                i = j;
+            }
+            previous = tokens.at(i);
+            continue;
+        }
+
+        if (!current)
+            continue;
+
+        if (t == "endmodule")
+        {
+            current = nullptr;
+            previous = ";";
+        }
+        else if ((t == "function" || t == "task") && previous != "import" && previous != "export")
+        {
+            // Their arguments are declared with input/output too
+            const QString end = "end" + t;
+            while (i < n && tokens.at(i) != end)
+                i++;
+            previous = ";";
+        }
+        else if (t == "input" || t == "output" || t == "inout")
+        {
+            i = parsePortDeclaration(tokens, i, current->ports);
+            previous = i < n ? tokens.at(i) : QString(";");
+        }
+        else
+        {
+            // "type [#(...)] instance (" or "type instance [n] (" starts an instantiation
+            if (isStatementBoundary(previous) && isIdentifier(t))
+            {
+                int j = i + 1;
+                if (j < n && tokens.at(j) == "#")
+                {
+                    j++;
+                    if (j < n && tokens.at(j) == "(")
+                        j = skipBalanced(tokens, j);
+                    j++;
+                }
+                if (j + 1 < n && isIdentifier(tokens.at(j)) && (tokens.at(j + 1) == "(" || tokens.at(j + 1) == "["))
+                    current->instances.insert(tokens.at(j), t);
+            }
+            previous = t;
+        }
+    }
+
+    return fileModules;
+}
+
+void RtlPortScanner::clear()
+{
+    errorString.clear();
+    modules.clear();
+    instanceModules.clear();
+}
+
+void RtlPortScanner::addModules(const QHash<QString, RtlModuleInfo> &fileModules)
+{
+    for (auto it = fileModules.constBegin(); it != fileModules.constEnd(); ++it)
+    {
+        modules.insert(it.key(), it.value());
+        for (auto inst = it->instances.constBegin(); inst != it->instances.constEnd(); ++inst)
+            instanceModules.insert(inst.key(), inst.value());
+    }
+}
+
+bool RtlPortScanner::beginScanDirectory(const QString &rtlDir, QFuture<RtlFileJob> *future)
+{
+    const QString absDir = QFileInfo(rtlDir).absoluteFilePath();
+    QStringList files = findRtlFiles(absDir);
+    if (files.isEmpty())
+    {
+        clear();
+        errorString = QString("No Verilog or SystemVerilog files found in %1").arg(rtlDir);
+        return false;
+    }
+
+    // Deleted sources must not keep contributing modules
+    QSet<QString> present;
+    for (const QString &path : files)
+        present.insert(QFileInfo(path).absoluteFilePath());
+    RtlScanCache::instance().removeMissing(absDir, present);
+
+    *future = beginScan(files);
+    return true;
+}
+
+QFuture<RtlFileJob> RtlPortScanner::beginScan(const QStringList &files)
+{
+    scanTimer.start();
+    clear();
+    parsedFiles = 0;
+
+    RtlScanCache &cache = RtlScanCache::instance();
+
+    // Unchanged files are answered from the cache; the rest go to the pool
+    QVector<QHash<QString, RtlModuleInfo>> &fileModules = pendingModules;
+    fileModules = QVector<QHash<QString, RtlModuleInfo>>(files.size());
+    QVector<RtlFileJob> jobs;
+    for (int i = 0; i < files.size(); i++)
+    {
+        QFileInfo info(files.at(i));
+        RtlFileJob job;
+        job.index = i;
+        job.path = info.absoluteFilePath();
+        job.size = info.size();
+        job.modified = info.lastModified().toMSecsSinceEpoch();
+        job.readable = false;
+        job.parsed = false;
+
+        RtlScanCache::Entry cached;
+        if (cache.lookup(job.path, &cached))
+        {
+            if (cached.size == job.size && cached.modified == job.modified)
+            {
+                fileModules[i] = cached.modules;
+                continue;
+            }
+            job.cachedHash = cached.hash;
+            fileModules[i] = cached.modules; // Kept if only the timestamp moved
+        }
+        jobs.append(job);
+    }
+
+    // Nothing to parse still gives a future, already finished
+    return QtConcurrent::mapped(jobs, scanRtlFile);
+}
+
+bool RtlPortScanner::finishScan(const QFuture<RtlFileJob> &future)
+{
+    RtlScanCache &cache = RtlScanCache::instance();
+    QVector<QHash<QString, RtlModuleInfo>> fileModules;
+    fileModules.swap(pendingModules);
+
+    const QList<RtlFileJob> results = future.results();
+    if (!results.isEmpty())
+    {
+        for (RtlFileJob done : results)
+        {
+            if (!done.readable)
+            {
+                qDebug() << "Cannot read RTL file:" << done.path;
+                fileModules[done.index].clear();
+                continue;
+            }
+            if (done.parsed)
+            {
+                fileModules[done.index] = done.result.modules;
+                parsedFiles++;
+            }
+            else
+            {
+                done.result.modules = fileModules.at(done.index);
+            }
+            cache.store(done.path, done.result);
+        }
+        cache.save();
+    }
+
+    // In list order, so a module defined twice resolves the same way every time
+    for (const QHash<QString, RtlModuleInfo> &found : fileModules)
+        addModules(found);
+
+    qDebug() << "RTL scan:" << fileModules.size() << "files (" << parsedFiles << "parsed,"
+             << fileModules.size() - parsedFiles << "cached )," << modules.size() << "modules in"
+             << scanTimer.elapsed() << "ms";
+
+    if (modules.isEmpty())
+    {
+        errorString = "No module declarations found in the RTL files";
+        return false;
+    }
+    return true;
+}
+
+// VCD names may carry a bit range ("data [7:0]" or "data[3]")
+static QString portNameOf(const QString &signalName)
+{
+    int end = signalName.size();
+    for (int i = 0; i < signalName.size(); i++)
+    {
+        if (signalName.at(i) == ' ' || signalName.at(i) == '[')
+        {
+            end = i;
+            break;
+        }
+    }
+    return signalName.left(end);
+}
+
+int RtlPortScanner::applyTo(VCDParser &parser) const
+{
+    const VCDScopeTree &tree = parser.getScopeTree();
+    const int scopeCount = parser.getScopeCount();
+
+    // Module whose body declares each scope; generate blocks and other
+    // unnamed levels inherit their parent's. Parents come before children.
+    QVector<QString> enclosing(scopeCount);
+    int applied = 0;
+
+    for (int s = 1; s < scopeCount; s++)
+    {
+        const QString name = parser.getScopeName(s);
+        const QString &outer = enclosing.at(parser.getScopeParent(s));
+
+        // Prefer the instantiation in the enclosing module, then a module of
+        // the same name (top level), then any instance of that name
+        QString module;
+        auto outerIt = modules.constFind(outer);
+        if (outerIt != modules.constEnd())
+            module = outerIt->instances.value(name);
+        if (module.isEmpty() && modules.contains(name))
+            module = name;
+        if (module.isEmpty())
+            module = instanceModules.value(name);
+
+        auto it = modules.constFind(module);
+        if (it == modules.constEnd())
+        {
+            enclosing[s] = outer;
+            continue;
+        }
+        enclosing[s] = module;
+
+        for (int i = tree.signalBegin[s]; i < tree.signalEnd[s]; i++)
+        {
+            SignalHandle handle = tree.signalOrder[i];
+            auto port = it->ports.constFind(portNameOf(parser.getSignalName(handle)));
+            if (port != it->ports.constEnd())
+            {
+                parser.setSignalDirection(handle, port.value());
+                applied++;
+            }
+        }
+    }
+
+    qDebug() << "RTL ports applied to" << applied << "signals";
+    return applied;
+}
@@ -0,0 +1,116 @@
+#ifndef RTLPORTSCANNER_H
+#define RTLPORTSCANNER_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+#include <QByteArray>
+#include <QFuture>
+#include <QVector>
+#include <QElapsedTimer>
+#include "vcdparser.h"
+
+// Port declarations and instantiations of one Verilog/SystemVerilog module
+struct RtlModuleInfo {
+    QHash<QString, QString> ports;     // Port name -> "input", "output" or "inout"
+    QHash<QString, QString> instances; // Instance name -> module type
+};
+
+// NEW: Per-file scan results, reused while a file's size and modification
+// time are unchanged, or while its content hash is (a touched file). Kept in
+// memory and in a JSON file under the cache location, so neither a second
+// port filter nor a restart re-parses sources nobody edited.
+// Used from the GUI thread only.
+class RtlScanCache
+{
+public:
+    struct Entry
+    {
+        qint64 size = -1;
+        qint64 modified = 0; // ms since epoch
+        QByteArray hash;     // SHA-1 of the content
+        QHash<QString, RtlModuleInfo> modules;
+    };
+
+    static RtlScanCache &instance();
+
+    bool lookup(const QString &path, Entry *entry);
+    void store(const QString &path, const Entry &entry);
+
+    // Forget files under dir that a scan no longer found
+    void removeMissing(const QString &dir, const QSet<QString> &present);
+    void save();
+
+private:
+    RtlScanCache();
+    void load();
+    QString cacheFilePath() const;
+
+    QHash<QString, Entry> entries; // Absolute path -> results
+    bool loaded;
+    bool dirty;
+};
+
+// One file whose cached results are missing or out of date
+struct RtlFileJob
+{
+    int index;                   // Position in the scanned file list
+    QString path;
+    qint64 size;
+    qint64 modified;
+    QByteArray cachedHash;       // Empty when the file was never scanned
+    RtlScanCache::Entry result;
+    bool readable;
+    bool parsed;                 // False when only the timestamp had changed
+};
+
+// Reads module port directions straight from .v/.sv sources and attaches
+// them to the parser's signals in memory. The dump itself is never read or
+// copied: VCD scopes are matched to modules through the instantiations
+// found in the RTL, starting from the top-level module names.
+class RtlPortScanner
+{
+public:
+    RtlPortScanner();
+
+    // Every .v/.sv file below dir, subdirectories included
+    static QStringList findRtlFiles(const QString &dir);
+
+    // Modules declared in one source text
+    static QHash<QString, RtlModuleInfo> parseSource(const QString &text);
+
+    // Files are parsed in parallel; unchanged ones come from RtlScanCache.
+    // begin*() answers cached files and starts parsing the rest on the pool;
+    // once the future has finished (see QFutureWatcher), finishScan() stores
+    // the results and builds the module table. Both run on the GUI thread,
+    // and this scanner may not start another scan in between.
+    bool beginScanDirectory(const QString &rtlDir, QFuture<RtlFileJob> *future);
+    QFuture<RtlFileJob> beginScan(const QStringList &files);
+    bool finishScan(const QFuture<RtlFileJob> &future);
+
+    void clear();
+    int getModuleCount() const { return modules.size(); }
+    QString getError() const { return errorString; }
+
+    // Sets the direction of every signal that is a port of its scope's
+    // module; returns how many signals received one
+    int applyTo(VCDParser &parser) const;
+
+    // Files actually parsed by the last scan, the rest were cached
+    int getParsedFileCount() const { return parsedFiles; }
+
+private:
+    void addModules(const QHash<QString, RtlModuleInfo> &fileModules);
+
+    QString errorString;
+    int parsedFiles;
+    QHash<QString, RtlModuleInfo> modules;    // Module name -> ports and instances
+    QHash<QString, QString> instanceModules;  // Any instance name -> module type
+
+    // Between beginScan() and finishScan(): modules of the cached files
+    QVector<QHash<QString, RtlModuleInfo>> pendingModules;
+    QElapsedTimer scanTimer;
+};
+
+#endif // RTLPORTSCANNER_H
@@ -0,0 +1,140 @@
+#include "signalcache.h"
+#include "vcdparser.h"
+#include <QMutexLocker>
+#include <QDebug>
+
+// Signals used this recently are on screen: never evict them, even when over
+// the limit, or a view with more rows than the budget would reload forever
+static const qint64 RECENT_USE_MS = 2000;
+static const qint64 DEFAULT_LIMIT_BYTES = qint64(2048) * 1024 * 1024;
+
+SignalCache &SignalCache::instance()
+{
+    static SignalCache cache;
+    return cache;
+}
+
+SignalCache::SignalCache()
+    : limit(DEFAULT_LIMIT_BYTES), used(0)
+{
+    clock.start();
+}
+
+void SignalCache::setLimitBytes(qint64 bytes)
+{
+    {
+        QMutexLocker locker(&mutex);
+        limit = qMax(qint64(1024) * 1024, bytes);
+    }
+    enforceLimit();
+}
+
+void SignalCache::insert(VCDParser *owner, const QString &key, qint64 bytes)
+{
+    QMutexLocker locker(&mutex);
+
+    auto existing = index.find(EntryKey(owner, key));
+    if (existing != index.end())
+    {
+        used -= existing.value()->bytes;
+        entries.erase(existing.value());
+        index.erase(existing);
+    }
+
+    Entry entry;
+    entry.owner = owner;
+    entry.key = key;
+    entry.bytes = bytes;
+    entry.lastUse = clock.elapsed();
+    entries.push_front(entry);
+    index.insert(EntryKey(owner, key), entries.begin());
+    used += bytes;
+}
+
+void SignalCache::touch(VCDParser *owner, const QString &key)
+{
+    QMutexLocker locker(&mutex);
+
+    auto it = index.constFind(EntryKey(owner, key));
+    if (it == index.constEnd())
+        return;
+
+    std::list<Entry>::iterator entry = it.value();
+    entry->lastUse = clock.elapsed();
+    entries.splice(entries.begin(), entries, entry);
+}
+
+void SignalCache::remove(VCDParser *owner, const QString &key)
+{
+    QMutexLocker locker(&mutex);
+
+    auto it = index.find(EntryKey(owner, key));
+    if (it == index.end())
+        return;
+
+    used -= it.value()->bytes;
+    entries.erase(it.value());
+    index.erase(it);
+}
+
+void SignalCache::setPinnedBytes(VCDParser *owner, qint64 bytes)
+{
+    QMutexLocker locker(&mutex);
+
+    used += bytes - pinned.value(owner);
+    if (bytes > 0)
+        pinned.insert(owner, bytes);
+    else
+        pinned.remove(owner);
+}
+
+void SignalCache::removeAll(VCDParser *owner)
+{
+    QMutexLocker locker(&mutex);
+
+    used -= pinned.take(owner);
+    for (auto it = entries.begin(); it != entries.end();)
+    {
+        if (it->owner == owner)
+        {
+            used -= it->bytes;
+            index.remove(EntryKey(it->owner, it->key));
+            it = entries.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void SignalCache::enforceLimit()
+{
+    QMutexLocker locker(&mutex);
+
+    const qint64 now = clock.elapsed();
+    int evicted = 0;
+
+    while (used > limit && !entries.empty())
+    {
+        const Entry &oldest = entries.back();
+        if (now - oldest.lastUse < RECENT_USE_MS)
+            break; // Everything left is in use
+
+        VCDParser *owner = oldest.owner;
+        QString key = oldest.key;
+
+        used -= oldest.bytes;
+        index.remove(EntryKey(owner, key));
+        entries.pop_back();
+
+        owner->evictSignalData(key);
+        evicted++;
+    }
+
+    if (evicted > 0)
+    {
+        qDebug() << "Signal cache evicted" << evicted << "signals, using"
+                 << used / (1024 * 1024) << "of" << limit / (1024 * 1024) << "MB";
+    }
+}
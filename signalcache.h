@@ -0,0 +1,59 @@
+#ifndef SIGNALCACHE_H
+#define SIGNALCACHE_H
+
+#include <QString>
+#include <QHash>
+#include <QPair>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <list>
+
+class VCDParser;
+
+// Byte-accounted LRU over the value changes of loaded signals. One instance
+// is shared by every parser, so the memory ceiling applies to the whole
+// process. Evicted signals are reloaded by their parser on the next access.
+class SignalCache
+{
+public:
+    static SignalCache &instance();
+
+    void setLimitBytes(qint64 bytes);
+    qint64 limitBytes() const { return limit; }
+    qint64 usedBytes() const { return used; }
+
+    void insert(VCDParser *owner, const QString &key, qint64 bytes);
+    void touch(VCDParser *owner, const QString &key);
+    void remove(VCDParser *owner, const QString &key);
+    void removeAll(VCDParser *owner);
+
+    // Bytes an owner holds that cannot be evicted, such as a stream, which
+    // cannot be read again. They count against the limit, so other signals
+    // make room for them; the owner trims them itself when over.
+    void setPinnedBytes(VCDParser *owner, qint64 bytes);
+
+    // Evict least recently drawn signals until usage fits the limit
+    void enforceLimit();
+
+private:
+    SignalCache();
+
+    struct Entry
+    {
+        VCDParser *owner;
+        QString key;
+        qint64 bytes;
+        qint64 lastUse; // ms on 'clock'
+    };
+    typedef QPair<VCDParser *, QString> EntryKey;
+
+    std::list<Entry> entries; // Most recently used first
+    QHash<EntryKey, std::list<Entry>::iterator> index;
+    QHash<VCDParser *, qint64> pinned;
+    qint64 limit;
+    qint64 used;
+    QElapsedTimer clock;
+    QMutex mutex;
+};
+
+#endif // SIGNALCACHE_H
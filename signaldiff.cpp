@@ -0,0 +1,86 @@
+#include "signaldiff.h"
+#include "vcdparser.h"
+#include <climits>
+
+static ushort extensionDigit(const QString &value)
+{
+    const ushort lead = value.isEmpty() ? '0' : value.at(0).toLower().unicode();
+    return (lead == 'x' || lead == 'z') ? lead : '0';
+}
+
+bool SignalDiff::sameValue(const QString &a, const QString &b)
+{
+    if (a.size() == b.size() && a.compare(b, Qt::CaseInsensitive) == 0)
+    {
+        return true;
+    }
+
+    // Walk from the least significant digit; the shorter one is extended
+    const ushort extendA = extensionDigit(a);
+    const ushort extendB = extensionDigit(b);
+    const int length = qMax(a.size(), b.size());
+    for (int i = 1; i <= length; i++)
+    {
+        const ushort digitA = i <= a.size() ? a.at(a.size() - i).toLower().unicode() : extendA;
+        const ushort digitB = i <= b.size() ? b.at(b.size() - i).toLower().unicode() : extendB;
+        if (digitA != digitB)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+QVector<SignalDiff::Interval> SignalDiff::compare(const QVector<VCDValueChange> &left,
+                                                  const QVector<VCDValueChange> &right, int endTime)
+{
+    QVector<Interval> mismatches;
+    int i = 0;
+    int j = 0;
+    const QString *leftValue = nullptr; // Nothing until the first change
+    const QString *rightValue = nullptr;
+    int openSince = -1;
+
+    while (i < left.size() || j < right.size())
+    {
+        const int leftTime = i < left.size() ? left[i].timestamp : INT_MAX;
+        const int rightTime = j < right.size() ? right[j].timestamp : INT_MAX;
+        const int time = qMin(leftTime, rightTime);
+
+        // Several changes at one time: the last one holds
+        while (i < left.size() && left[i].timestamp == time)
+        {
+            leftValue = &left[i++].value;
+        }
+        while (j < right.size() && right[j].timestamp == time)
+        {
+            rightValue = &right[j++].value;
+        }
+
+        bool same;
+        if (leftValue && rightValue)
+        {
+            same = leftValue == rightValue || sameValue(*leftValue, *rightValue);
+        }
+        else
+        {
+            same = !leftValue && !rightValue;
+        }
+
+        if (!same && openSince < 0)
+        {
+            openSince = time;
+        }
+        else if (same && openSince >= 0)
+        {
+            mismatches.append({openSince, time});
+            openSince = -1;
+        }
+    }
+
+    if (openSince >= 0)
+    {
+        mismatches.append({openSince, qMax(endTime, openSince + 1)});
+    }
+    return mismatches;
+}
@@ -0,0 +1,42 @@
+#ifndef SIGNALDIFF_H
+#define SIGNALDIFF_H
+
+#include <QString>
+#include <QVector>
+
+struct VCDValueChange;
+
+// NEW: Compares two value-change streams in lockstep: two signals of one
+// dump, or one signal in a golden and a failing dump. Both streams are walked
+// once, moving whichever changes next (both when they change together), and
+// the stretches where the values differ are collected. Values are compared as
+// VCD writes them, so "b1" and "b0001" are the same value and x/z compare
+// like any other digit.
+class SignalDiff
+{
+public:
+    struct Interval
+    {
+        int start;
+        int end; // Exclusive
+    };
+
+    struct Result
+    {
+        QString leftName;
+        QString rightName;
+        QVector<Interval> mismatches;
+        int firstDivergence = -1; // -1 when the signals agree
+        qint64 mismatchTime = 0;  // Total length of the mismatches
+        bool missing = false;     // One side has no such signal
+    };
+
+    // 'endTime' closes a mismatch still open after the last change
+    static QVector<Interval> compare(const QVector<VCDValueChange> &left, const QVector<VCDValueChange> &right,
+                                     int endTime);
+
+    // Equal after VCD left-extension (0, or the leading x/z) and ignoring case
+    static bool sameValue(const QString &a, const QString &b);
+};
+
+#endif // SIGNALDIFF_H
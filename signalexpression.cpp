@@ -0,0 +1,735 @@
+#include "signalexpression.h"
+#include "signalnameindex.h"
+#include "edgeindex.h"
+#include <QRegularExpression>
+#include <QStringView>
+#include <QDebug>
+#include <climits>
+
+namespace
+{
+enum Operator
+{
+    LogicalOr,
+    LogicalAnd,
+    BitOr,
+    BitXor,
+    BitAnd,
+    Equal,
+    NotEqual,
+    Less,
+    LessEqual,
+    Greater,
+    GreaterEqual,
+    ShiftLeft,
+    ShiftRight,
+    Add,
+    Subtract,
+    Multiply,
+    Divide,
+    Modulo,
+    BitNot,
+    LogicalNot,
+    Negate
+};
+
+struct OperatorToken
+{
+    const char *text;
+    Operator op;
+};
+
+// Binary operators per precedence tier, loosest first. Within a tier the
+// longer spellings come first so "<=" is not read as "<".
+const QVector<QVector<OperatorToken>> &binaryTiers()
+{
+    static const QVector<QVector<OperatorToken>> tiers = {
+        {{"||", LogicalOr}},
+        {{"&&", LogicalAnd}},
+        {{"|", BitOr}},
+        {{"^", BitXor}},
+        {{"&", BitAnd}},
+        {{"==", Equal}, {"!=", NotEqual}},
+        {{"<=", LessEqual}, {">=", GreaterEqual}, {"<", Less}, {">", Greater}},
+        {{"<<", ShiftLeft}, {">>", ShiftRight}},
+        {{"+", Add}, {"-", Subtract}},
+        {{"*", Multiply}, {"/", Divide}, {"%", Modulo}},
+    };
+    return tiers;
+}
+
+quint64 widthMask(int width)
+{
+    return width >= 64 ? ~quint64(0) : (quint64(1) << width) - 1;
+}
+
+int bitsNeeded(quint64 value)
+{
+    int bits = 1;
+    while (bits < 64 && (value >> bits))
+        bits++;
+    return bits;
+}
+
+bool isNameStart(QChar c)
+{
+    return c.isLetter() || c == QLatin1Char('_') || c == QLatin1Char('\\');
+}
+
+bool isNameChar(QChar c)
+{
+    return c.isLetterOrNumber() || c == QLatin1Char('_') || c == QLatin1Char('.') || c == QLatin1Char('$') ||
+           c == QLatin1Char('\\');
+}
+} // namespace
+
+SignalExpression::SignalExpression()
+    : root(-1), resultWidth(1), parser(nullptr), pos(0)
+{
+}
+
+bool SignalExpression::compile(const QString &text, const VCDParser &vcdParser)
+{
+    source = text.trimmed();
+    error.clear();
+    nodes.clear();
+    inputNames.clear();
+    inputWidths.clear();
+    inputLsb.clear();
+    root = -1;
+    parser = &vcdParser;
+    pos = 0;
+
+    if (source.isEmpty())
+    {
+        error = "Empty expression";
+        return false;
+    }
+
+    root = parseBinary(0);
+    skipSpace();
+    if (root >= 0 && pos < source.size())
+    {
+        error = QString("Unexpected '%1' at position %2").arg(source.mid(pos, 10)).arg(pos + 1);
+        root = -1;
+    }
+    parser = nullptr;
+
+    if (root < 0)
+    {
+        nodes.clear();
+        inputNames.clear();
+        return false;
+    }
+
+    resultWidth = nodes[root].width;
+    return true;
+}
+
+void SignalExpression::skipSpace()
+{
+    while (pos < source.size() && source.at(pos).isSpace())
+        pos++;
+}
+
+bool SignalExpression::accept(const char *token)
+{
+    skipSpace();
+    const QLatin1String spelling(token);
+    if (!QStringView(source).mid(pos).startsWith(spelling))
+        return false;
+
+    // "|" must not take the first half of "||", nor "<" the start of "<="
+    const int end = pos + spelling.size();
+    if (spelling.size() == 1 && end < source.size())
+    {
+        const QChar next = source.at(end);
+        const char c = token[0];
+        if ((c == '|' || c == '&') && next == QLatin1Char(c))
+            return false;
+        if ((c == '<' || c == '>') && (next == QLatin1Char('=') || next == QLatin1Char(c)))
+            return false;
+        if ((c == '!' || c == '=') && next == QLatin1Char('='))
+            return false;
+    }
+
+    pos = end;
+    return true;
+}
+
+int SignalExpression::addNode(const Node &node)
+{
+    nodes.append(node);
+    return nodes.size() - 1;
+}
+
+int SignalExpression::parseBinary(int level)
+{
+    const auto &tiers = binaryTiers();
+    if (level >= tiers.size())
+        return parseUnary();
+
+    int left = parseBinary(level + 1);
+    while (left >= 0)
+    {
+        int op = -1;
+        for (const OperatorToken &token : tiers[level])
+        {
+            if (accept(token.text))
+            {
+                op = token.op;
+                break;
+            }
+        }
+        if (op < 0)
+            break;
+
+        const int right = parseBinary(level + 1);
+        if (right < 0)
+            return -1;
+
+        Node node;
+        node.kind = BinaryNode;
+        node.op = op;
+        node.left = left;
+        node.right = right;
+
+        const int a = nodes[left].width;
+        const int b = nodes[right].width;
+        switch (op)
+        {
+        case LogicalOr:
+        case LogicalAnd:
+        case Equal:
+        case NotEqual:
+        case Less:
+        case LessEqual:
+        case Greater:
+        case GreaterEqual:
+            node.width = 1;
+            break;
+        case Multiply:
+            node.width = qMin(64, a + b);
+            break;
+        case Divide:
+        case Modulo:
+        case ShiftLeft:
+        case ShiftRight:
+            node.width = a;
+            break;
+        default:
+            node.width = qMax(a, b);
+            break;
+        }
+        left = addNode(node);
+    }
+    return left;
+}
+
+int SignalExpression::parseUnary()
+{
+    int op = -1;
+    if (accept("~"))
+        op = BitNot;
+    else if (accept("!"))
+        op = LogicalNot;
+    else if (accept("-"))
+        op = Negate;
+
+    if (op < 0)
+        return parsePrimary();
+
+    const int child = parseUnary();
+    if (child < 0)
+        return -1;
+
+    Node node;
+    node.kind = UnaryNode;
+    node.op = op;
+    node.left = child;
+    node.width = op == LogicalNot ? 1 : nodes[child].width;
+    return addNode(node);
+}
+
+int SignalExpression::parsePrimary()
+{
+    skipSpace();
+    if (pos >= source.size())
+    {
+        error = "Expression ends too early";
+        return -1;
+    }
+
+    if (accept("("))
+    {
+        const int inner = parseBinary(0);
+        if (inner < 0)
+            return -1;
+        if (!accept(")"))
+        {
+            error = QString("Missing ')' at position %1").arg(pos + 1);
+            return -1;
+        }
+        return inner;
+    }
+
+    const QChar c = source.at(pos);
+    if (c.isDigit() || c == QLatin1Char('\''))
+    {
+        Node node;
+        node.kind = ConstantNode;
+        if (!parseNumber(&node.constant, &node.width))
+            return -1;
+        return addNode(node);
+    }
+
+    if (!isNameStart(c))
+    {
+        error = QString("Unexpected '%1' at position %2").arg(c).arg(pos + 1);
+        return -1;
+    }
+
+    const int start = pos;
+    while (pos < source.size() && isNameChar(source.at(pos)))
+        pos++;
+    const QString name = source.mid(start, pos - start);
+
+    // "name[...]": a signal literally called that, a bus with that range,
+    // or a bit select of the bus
+    QString select;
+    if (pos < source.size() && source.at(pos) == QLatin1Char('['))
+    {
+        const int close = source.indexOf(QLatin1Char(']'), pos);
+        if (close < 0)
+        {
+            error = QString("Missing ']' after %1").arg(name);
+            return -1;
+        }
+        select = source.mid(pos + 1, close - pos - 1).trimmed();
+        const SignalHandle whole = resolve(name + "[" + select + "]");
+        const SignalHandle ranged = whole != InvalidSignalHandle ? whole : resolve(name + " [" + select + "]");
+        pos = close + 1;
+        if (ranged != InvalidSignalHandle)
+        {
+            const int input = addInput(ranged);
+            if (input < 0)
+                return -1;
+            Node node;
+            node.kind = InputNode;
+            node.input = input;
+            node.width = inputWidths[input];
+            return addNode(node);
+        }
+    }
+
+    const SignalHandle handle = resolve(name);
+    if (handle == InvalidSignalHandle)
+    {
+        error = QString("Unknown signal '%1'").arg(name);
+        return -1;
+    }
+
+    const int input = addInput(handle);
+    if (input < 0)
+        return -1;
+
+    Node inputNode;
+    inputNode.kind = InputNode;
+    inputNode.input = input;
+    inputNode.width = inputWidths[input];
+    const int inputIndex = addNode(inputNode);
+    if (select.isEmpty())
+        return inputIndex;
+
+    // Bit select in the bus's own numbering
+    static const QRegularExpression selectPattern("^(\\d+)\\s*(?::\\s*(\\d+))?$");
+    const QRegularExpressionMatch match = selectPattern.match(select);
+    if (!match.hasMatch())
+    {
+        error = QString("Bad bit select [%1]").arg(select);
+        return -1;
+    }
+    int high = match.captured(1).toInt();
+    int low = match.captured(2).isEmpty() ? high : match.captured(2).toInt();
+    if (low > high)
+        qSwap(low, high);
+    low -= inputLsb[input];
+    high -= inputLsb[input];
+    if (low < 0 || high >= inputWidths[input])
+    {
+        error = QString("[%1] is outside %2").arg(select, inputNames[input]);
+        return -1;
+    }
+
+    Node node;
+    node.kind = SliceNode;
+    node.left = inputIndex;
+    node.low = low;
+    node.width = high - low + 1;
+    return addNode(node);
+}
+
+bool SignalExpression::parseNumber(quint64 *value, int *width)
+{
+    // Optional Verilog size and base: 8'hFF, 'b1010
+    int size = 0;
+    int base = 10;
+    const int start = pos;
+    while (pos < source.size() && source.at(pos).isDigit())
+        pos++;
+
+    if (pos < source.size() && source.at(pos) == QLatin1Char('\''))
+    {
+        size = source.mid(start, pos - start).toInt();
+        pos++;
+        const QChar b = pos < source.size() ? source.at(pos).toLower() : QChar();
+        base = b == QLatin1Char('h') ? 16 : b == QLatin1Char('b') ? 2 : b == QLatin1Char('o') ? 8 : b == QLatin1Char('d') ? 10 : 0;
+        if (base == 0)
+        {
+            error = QString("Bad number base at position %1").arg(pos + 1);
+            return false;
+        }
+        pos++;
+    }
+    else
+    {
+        pos = start;
+        if (QStringView(source).mid(pos).startsWith(QLatin1String("0x"), Qt::CaseInsensitive))
+        {
+            base = 16;
+            pos += 2;
+        }
+        else if (QStringView(source).mid(pos).startsWith(QLatin1String("0b"), Qt::CaseInsensitive))
+        {
+            base = 2;
+            pos += 2;
+        }
+    }
+
+    const int digitsStart = pos;
+    while (pos < source.size() && (source.at(pos).isLetterOrNumber() || source.at(pos) == QLatin1Char('_')))
+        pos++;
+    QString digits = source.mid(digitsStart, pos - digitsStart);
+    digits.remove(QLatin1Char('_'));
+
+    bool ok = false;
+    *value = digits.toULongLong(&ok, base);
+    if (!ok)
+    {
+        error = QString("Bad number '%1'").arg(source.mid(start, pos - start));
+        return false;
+    }
+
+    *width = size > 0 ? qMin(size, 64) : bitsNeeded(*value);
+    *value &= widthMask(*width);
+    return true;
+}
+
+SignalHandle SignalExpression::resolve(const QString &name) const
+{
+    SignalHandle handle = parser->findSignal(name);
+    if (handle != InvalidSignalHandle)
+        return handle;
+
+    // A bus may be named without its " [7:0]" range
+    const QBitArray candidates = parser->getNameIndex().search(name);
+    for (int h = 0; h < candidates.size(); h++)
+    {
+        if (!candidates.testBit(h))
+            continue;
+        QString fullName = parser->getFullName(SignalHandle(h));
+        const int range = fullName.lastIndexOf(" [");
+        if (range > 0 && fullName.left(range) == name)
+            return SignalHandle(h);
+    }
+    return InvalidSignalHandle;
+}
+
+int SignalExpression::addInput(SignalHandle handle)
+{
+    const QString fullName = parser->getFullName(handle);
+    int input = inputNames.indexOf(fullName);
+    if (input >= 0)
+        return input;
+
+    const int width = parser->getSignalWidth(handle);
+    if (width > 64)
+    {
+        error = QString("%1 is %2 bits wide; at most 64 are supported").arg(fullName).arg(width);
+        return -1;
+    }
+
+    static const QRegularExpression rangePattern("\\[(\\d+)(?::(\\d+))?\\]$");
+    const QRegularExpressionMatch range = rangePattern.match(fullName);
+    int lsb = 0;
+    if (range.hasMatch() && !range.captured(2).isEmpty())
+        lsb = qMin(range.captured(1).toInt(), range.captured(2).toInt());
+
+    inputNames.append(fullName);
+    inputWidths.append(qMax(1, width));
+    inputLsb.append(lsb);
+    return inputNames.size() - 1;
+}
+
+SignalExpression::Value SignalExpression::parseValue(const QString &text, int width)
+{
+    Value value;
+    const int size = text.size();
+    for (int bit = 0; bit < size && bit < 64; bit++)
+    {
+        switch (text.at(size - 1 - bit).unicode())
+        {
+        case '0':
+            break;
+        case '1':
+            value.bits |= quint64(1) << bit;
+            break;
+        case 'x':
+        case 'X':
+        case 'z':
+        case 'Z':
+            value.unknown |= quint64(1) << bit;
+            break;
+        default:
+            value.unknown = widthMask(width); // A real: no bits to read
+            value.bits = 0;
+            return value;
+        }
+    }
+
+    // VCD left-extends a shortened value with 0, or with its x/z digit
+    if (size > 0 && size < width && (value.unknown >> (size - 1)) & 1)
+        value.unknown |= widthMask(width) & ~widthMask(size);
+
+    value.bits &= widthMask(width);
+    value.unknown &= widthMask(width);
+    return value;
+}
+
+QString SignalExpression::formatValue(const Value &value) const
+{
+    if (resultWidth == 1)
+        return value.unknown & 1 ? QStringLiteral("X") : (value.bits & 1 ? QStringLiteral("1") : QStringLiteral("0"));
+
+    if (value.unknown == widthMask(resultWidth))
+        return QStringLiteral("x");
+
+    QString text(resultWidth, QLatin1Char('0'));
+    for (int bit = 0; bit < resultWidth; bit++)
+    {
+        const quint64 flag = quint64(1) << bit;
+        if (value.unknown & flag)
+            text[resultWidth - 1 - bit] = QLatin1Char('x');
+        else if (value.bits & flag)
+            text[resultWidth - 1 - bit] = QLatin1Char('1');
+    }
+    return text;
+}
+
+SignalExpression::Value SignalExpression::evaluateNode(int index, const QVector<Value> &inputs) const
+{
+    const Node &node = nodes[index];
+    const quint64 mask = widthMask(node.width);
+    Value result;
+
+    switch (node.kind)
+    {
+    case InputNode:
+        return inputs[node.input];
+
+    case ConstantNode:
+        result.bits = node.constant;
+        return result;
+
+    case SliceNode:
+    {
+        const Value v = evaluateNode(node.left, inputs);
+        result.bits = (v.bits >> node.low) & mask;
+        result.unknown = (v.unknown >> node.low) & mask;
+        return result;
+    }
+
+    case UnaryNode:
+    {
+        const Value v = evaluateNode(node.left, inputs);
+        if (node.op == BitNot)
+        {
+            result.unknown = v.unknown;
+            result.bits = ~v.bits & ~v.unknown & mask;
+        }
+        else if (node.op == LogicalNot)
+        {
+            // Known when any bit is a known 1
+            if (v.bits & ~v.unknown)
+                result.bits = 0;
+            else if (v.unknown)
+                result.unknown = 1;
+            else
+                result.bits = 1;
+        }
+        else if (v.unknown)
+        {
+            result.unknown = mask;
+        }
+        else
+        {
+            result.bits = (~v.bits + 1) & mask;
+        }
+        return result;
+    }
+
+    case BinaryNode:
+        break;
+    }
+
+    const Value a = evaluateNode(node.left, inputs);
+    const Value b = evaluateNode(node.right, inputs);
+
+    switch (node.op)
+    {
+    case BitAnd:
+    {
+        const quint64 knownZero = (~a.bits & ~a.unknown) | (~b.bits & ~b.unknown);
+        result.unknown = (a.unknown | b.unknown) & ~knownZero & mask;
+        result.bits = a.bits & b.bits & ~result.unknown & mask;
+        return result;
+    }
+    case BitOr:
+    {
+        const quint64 knownOne = (a.bits & ~a.unknown) | (b.bits & ~b.unknown);
+        result.unknown = (a.unknown | b.unknown) & ~knownOne & mask;
+        result.bits = (a.bits | b.bits) & ~result.unknown & mask;
+        return result;
+    }
+    case BitXor:
+        result.unknown = (a.unknown | b.unknown) & mask;
+        result.bits = (a.bits ^ b.bits) & ~result.unknown & mask;
+        return result;
+    case LogicalAnd:
+    case LogicalOr:
+    {
+        // A known operand can decide on its own
+        const bool aTrue = a.bits & ~a.unknown;
+        const bool bTrue = b.bits & ~b.unknown;
+        const bool aFalse = !a.unknown && !a.bits;
+        const bool bFalse = !b.unknown && !b.bits;
+        if (node.op == LogicalAnd)
+        {
+            if (aFalse || bFalse)
+                return result;
+            if (aTrue && bTrue)
+                result.bits = 1;
+            else
+                result.unknown = 1;
+        }
+        else
+        {
+            if (aTrue || bTrue)
+                result.bits = 1;
+            else if (!(aFalse && bFalse))
+                result.unknown = 1;
+        }
+        return result;
+    }
+    default:
+        break;
+    }
+
+    // Arithmetic and comparisons need every bit
+    if (a.unknown || b.unknown)
+    {
+        result.unknown = mask;
+        return result;
+    }
+
+    switch (node.op)
+    {
+    case Equal: result.bits = a.bits == b.bits; break;
+    case NotEqual: result.bits = a.bits != b.bits; break;
+    case Less: result.bits = a.bits < b.bits; break;
+    case LessEqual: result.bits = a.bits <= b.bits; break;
+    case Greater: result.bits = a.bits > b.bits; break;
+    case GreaterEqual: result.bits = a.bits >= b.bits; break;
+    case ShiftLeft: result.bits = b.bits >= 64 ? 0 : (a.bits << b.bits) & mask; break;
+    case ShiftRight: result.bits = b.bits >= 64 ? 0 : (a.bits >> b.bits) & mask; break;
+    case Add: result.bits = (a.bits + b.bits) & mask; break;
+    case Subtract: result.bits = (a.bits - b.bits) & mask; break;
+    case Multiply: result.bits = (a.bits * b.bits) & mask; break;
+    case Divide:
+    case Modulo:
+        if (b.bits == 0)
+            result.unknown = mask;
+        else
+            result.bits = (node.op == Divide ? a.bits / b.bits : a.bits % b.bits) & mask;
+        break;
+    default:
+        break;
+    }
+    return result;
+}
+
+QVector<VCDValueChange> SignalExpression::evaluate(const QVector<QVector<VCDValueChange>> &inputChanges,
+                                                   int from, int to) const
+{
+    QVector<VCDValueChange> result;
+    const int inputCount = inputNames.size();
+    if (root < 0 || inputChanges.size() != inputCount)
+        return result;
+
+    // Each input starts at its last change at or before 'from'
+    QVector<int> next(inputCount);
+    QVector<Value> values(inputCount);
+    int startTime = 0;
+    for (int i = 0; i < inputCount; i++)
+    {
+        const int held = EdgeIndex::upperBound(inputChanges[i], from) - 1;
+        next[i] = held + 1;
+        if (held >= 0)
+        {
+            values[i] = parseValue(inputChanges[i][held].value, inputWidths[i]);
+            startTime = qMax(startTime, inputChanges[i][held].timestamp);
+        }
+        else
+        {
+            values[i].unknown = widthMask(inputWidths[i]);
+        }
+    }
+
+    VCDValueChange change;
+    change.timestamp = startTime;
+    change.value = formatValue(evaluateNode(root, values));
+    result.append(change);
+
+    // Sweep the merged streams: every input changing at the earliest pending
+    // time moves together, and only real changes of the result are kept
+    for (;;)
+    {
+        int time = INT_MAX;
+        for (int i = 0; i < inputCount; i++)
+        {
+            if (next[i] < inputChanges[i].size())
+                time = qMin(time, inputChanges[i][next[i]].timestamp);
+        }
+        if (time == INT_MAX || time > to)
+            break;
+
+        for (int i = 0; i < inputCount; i++)
+        {
+            const QVector<VCDValueChange> &changes = inputChanges[i];
+            while (next[i] < changes.size() && changes[next[i]].timestamp == time)
+            {
+                values[i] = parseValue(changes[next[i]].value, inputWidths[i]);
+                next[i]++;
+            }
+        }
+
+        const QString value = formatValue(evaluateNode(root, values));
+        if (value != result.last().value)
+        {
+            change.timestamp = time;
+            change.value = value;
+            result.append(change);
+        }
+    }
+    return result;
+}
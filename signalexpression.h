@@ -0,0 +1,92 @@
+#ifndef SIGNALEXPRESSION_H
+#define SIGNALEXPRESSION_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "vcdparser.h"
+
+// NEW: Expression over existing signals, compiled once into a flat node
+// list and evaluated by sweeping the merged change streams of its inputs,
+// e.g. "top.valid & top.ready", "top.addr[31:12]" or "count_a - count_b".
+//
+// Operators, loosest first: ||  &&  |  ^  &  == !=  < <= > >=  << >>  + -
+// * / %  and the unary ~ ! -. Operands are full signal names (the " [7:0]"
+// range of a bus may be left out), bit selects name[i] / name[hi:lo], and
+// numbers: 42, 0x2A, 0b101010 or Verilog style 8'h2A. Values are at most
+// 64 bits; x/z bits propagate through bitwise operators and make every
+// other result x.
+class SignalExpression
+{
+public:
+    SignalExpression();
+
+    bool compile(const QString &text, const VCDParser &parser);
+    QString errorString() const { return error; }
+    QString text() const { return source; }
+    int width() const { return resultWidth; }
+
+    // Full names of the signals read, in the order evaluate() expects them
+    QStringList inputs() const { return inputNames; }
+
+    // Changes over [from, to], starting with the value held at 'from'
+    QVector<VCDValueChange> evaluate(const QVector<QVector<VCDValueChange>> &inputChanges, int from, int to) const;
+
+private:
+    struct Value
+    {
+        quint64 bits = 0;
+        quint64 unknown = 0; // x/z bits
+    };
+
+    enum NodeKind
+    {
+        InputNode,
+        ConstantNode,
+        SliceNode,
+        UnaryNode,
+        BinaryNode
+    };
+
+    struct Node
+    {
+        NodeKind kind;
+        int op = 0;     // Operator token for unary/binary nodes
+        int left = -1;  // Child nodes
+        int right = -1;
+        int input = -1; // Index into inputNames
+        quint64 constant = 0;
+        int low = 0;    // Slice bits [low, low + width)
+        int width = 1;
+    };
+
+    // Recursive descent, one level per precedence tier
+    int parseBinary(int level);
+    int parseUnary();
+    int parsePrimary();
+    bool parseNumber(quint64 *value, int *width);
+    int addNode(const Node &node);
+    int addInput(SignalHandle handle);
+    SignalHandle resolve(const QString &name) const;
+    void skipSpace();
+    bool accept(const char *token);
+
+    Value evaluateNode(int node, const QVector<Value> &inputs) const;
+    static Value parseValue(const QString &text, int width);
+    QString formatValue(const Value &value) const;
+
+    QString source;
+    QString error;
+    QVector<Node> nodes;
+    int root;
+    int resultWidth;
+    QStringList inputNames;
+    QVector<int> inputWidths;
+    QVector<int> inputLsb; // Lowest index of each input's declared range
+
+    // Compile state
+    const VCDParser *parser;
+    int pos;
+};
+
+#endif // SIGNALEXPRESSION_H
@@ -0,0 +1,216 @@
+#include "signalnameindex.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <iterator>
+
+static inline quint64 trigramKey(const QChar *c)
+{
+    return (quint64(c[0].unicode()) << 32) | (quint64(c[1].unicode()) << 16) | quint64(c[2].unicode());
+}
+
+SignalNameIndex::SignalNameIndex()
+    : signalCount(0)
+{
+}
+
+void SignalNameIndex::clear()
+{
+    signalCount = 0;
+    leafNames.clear();
+    leafBegin.clear();
+    leafSignals.clear();
+    signalLeaf.clear();
+    leafTrigrams.clear();
+    scopePaths.clear();
+    scopeParents.clear();
+    scopeNameLength.clear();
+    tree = VCDScopeTree();
+}
+
+void SignalNameIndex::build(const VCDParser &parser)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    clear();
+    signalCount = parser.getSignalCount();
+    tree = parser.getScopeTree();
+
+    // Deduplicate leaf names; most designs repeat the same few thousand
+    QHash<QString, quint32> leafIds;
+    QVector<int> leafCount;
+    signalLeaf.resize(signalCount);
+    for (int h = 0; h < signalCount; h++)
+    {
+        QString name = parser.getSignalName(h);
+        auto it = leafIds.constFind(name);
+        quint32 id;
+        if (it == leafIds.constEnd())
+        {
+            id = leafNames.size();
+            leafIds.insert(name, id);
+            leafNames.append(name.toLower());
+            leafCount.append(0);
+        }
+        else
+        {
+            id = it.value();
+        }
+        signalLeaf[h] = id;
+        leafCount[id]++;
+    }
+
+    leafBegin.resize(leafNames.size() + 1);
+    leafBegin[0] = 0;
+    for (int l = 0; l < leafNames.size(); l++)
+        leafBegin[l + 1] = leafBegin[l] + leafCount[l];
+
+    leafSignals.resize(signalCount);
+    QVector<int> next = leafBegin;
+    for (int h = 0; h < signalCount; h++)
+        leafSignals[next[signalLeaf[h]]++] = h;
+
+    // Posting lists stay sorted because leaf ids are visited in order
+    for (int l = 0; l < leafNames.size(); l++)
+    {
+        const QString &name = leafNames.at(l);
+        for (int i = 0; i + 3 <= name.size(); i++)
+        {
+            QVector<quint32> &postings = leafTrigrams[trigramKey(name.constData() + i)];
+            if (postings.isEmpty() || postings.last() != quint32(l))
+                postings.append(l);
+        }
+    }
+
+    // Scope paths, built parent first
+    const int scopeCount = parser.getScopeCount();
+    scopePaths.resize(scopeCount);
+    scopeParents.resize(scopeCount);
+    scopeNameLength.resize(scopeCount);
+    scopeParents[0] = 0;
+    scopeNameLength[0] = 0;
+    for (int s = 1; s < scopeCount; s++)
+    {
+        quint32 parent = parser.getScopeParent(s);
+        QString name = parser.getScopeName(s).toLower();
+        scopeParents[s] = parent;
+        scopeNameLength[s] = name.size();
+        scopePaths[s] = scopePaths[parent].isEmpty() ? name : scopePaths[parent] + "." + name;
+    }
+
+    qDebug() << "Name index built:" << leafNames.size() << "distinct leaf names," << leafTrigrams.size()
+             << "trigrams," << scopeCount << "scopes in" << timer.elapsed() << "ms";
+}
+
+// Ids of the leaf names containing needle (already lower-cased)
+QVector<quint32> SignalNameIndex::leavesContaining(const QString &needle) const
+{
+    QVector<quint32> ids;
+
+    if (needle.size() < 3)
+    {
+        // Too short for trigrams; the distinct names are a small set
+        for (int l = 0; l < leafNames.size(); l++)
+        {
+            if (leafNames.at(l).contains(needle))
+                ids.append(l);
+        }
+        return ids;
+    }
+
+    QVector<const QVector<quint32> *> lists;
+    for (int i = 0; i + 3 <= needle.size(); i++)
+    {
+        auto it = leafTrigrams.constFind(trigramKey(needle.constData() + i));
+        if (it == leafTrigrams.constEnd())
+            return ids;
+        lists.append(&it.value());
+    }
+
+    // Intersect the shortest posting lists first
+    std::sort(lists.begin(), lists.end(), [](const QVector<quint32> *a, const QVector<quint32> *b) {
+        return a->size() < b->size();
+    });
+
+    QVector<quint32> candidates = *lists.first();
+    for (int k = 1; k < lists.size() && !candidates.isEmpty(); k++)
+    {
+        QVector<quint32> narrowed;
+        std::set_intersection(candidates.constBegin(), candidates.constEnd(),
+                              lists.at(k)->constBegin(), lists.at(k)->constEnd(),
+                              std::back_inserter(narrowed));
+        candidates.swap(narrowed);
+    }
+
+    // Trigrams only narrow the set; confirm the substring itself
+    for (quint32 l : candidates)
+    {
+        if (leafNames.at(l).contains(needle))
+            ids.append(l);
+    }
+    return ids;
+}
+
+void SignalNameIndex::addScopeSignals(quint32 scope, QBitArray &result) const
+{
+    for (int i = tree.signalBegin[scope]; i < tree.signalEnd[scope]; i++)
+        result.setBit(tree.signalOrder[i]);
+}
+
+QBitArray SignalNameIndex::search(const QString &text) const
+{
+    QBitArray result(signalCount);
+    const QString needle = text.toLower();
+    if (needle.isEmpty())
+        return result;
+
+    // 1. Inside the leaf name
+    for (quint32 l : leavesContaining(needle))
+    {
+        for (int i = leafBegin[l]; i < leafBegin[l + 1]; i++)
+            result.setBit(leafSignals[i]);
+    }
+
+    // 2. Inside the scope path. A scope matches when its parent does, or when
+    //    a match ends within its own name, so only the path's tail is searched.
+    const int scopeCount = scopePaths.size();
+    QBitArray scopeMatches(scopeCount);
+    for (int s = 1; s < scopeCount; s++)
+    {
+        const QString &path = scopePaths.at(s);
+        bool matches = scopeMatches.testBit(scopeParents[s]);
+        if (!matches)
+        {
+            int ownStart = path.size() - scopeNameLength[s];
+            matches = path.indexOf(needle, qMax(0, ownStart - needle.size() + 1)) != -1;
+        }
+        if (matches)
+        {
+            scopeMatches.setBit(s);
+            addScopeSignals(s, result);
+        }
+    }
+
+    // 3. Across the '.' joining scope path and leaf: the part before a dot
+    //    must end the scope path and the part after it must start the leaf
+    for (int k = needle.indexOf('.'); k != -1; k = needle.indexOf('.', k + 1))
+    {
+        const QString left = needle.left(k);
+        const QString right = needle.mid(k + 1);
+        for (int s = 1; s < scopeCount; s++)
+        {
+            if (scopeMatches.testBit(s) || !scopePaths.at(s).endsWith(left))
+                continue;
+
+            for (int i = tree.signalBegin[s]; i < tree.signalEnd[s]; i++)
+            {
+                SignalHandle h = tree.signalOrder[i];
+                if (leafNames.at(signalLeaf[h]).startsWith(right))
+                    result.setBit(h);
+            }
+        }
+    }
+
+    return result;
+}
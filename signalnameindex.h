@@ -0,0 +1,48 @@
+#ifndef SIGNALNAMEINDEX_H
+#define SIGNALNAMEINDEX_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QBitArray>
+#include "vcdparser.h"
+
+// Case-insensitive substring search over full signal paths ("scope.path.leaf").
+// Leaf names are deduplicated and indexed by trigram; scope paths are few
+// in comparison and are matched with a linear pass over the scope tree.
+// A query can match in the leaf, in the scope path, or across the '.'
+// between them, and all three cases are resolved without building any
+// full signal path.
+class SignalNameIndex
+{
+public:
+    SignalNameIndex();
+
+    void build(const VCDParser &parser);
+    void clear();
+    bool isEmpty() const { return signalCount == 0; }
+
+    // Bit h is set when signal h's full path contains text; text must not be empty
+    QBitArray search(const QString &text) const;
+
+private:
+    QVector<quint32> leavesContaining(const QString &needle) const;
+    void addScopeSignals(quint32 scope, QBitArray &result) const;
+
+    int signalCount;
+
+    // Distinct lower-cased leaf names and the signals carrying each one
+    QVector<QString> leafNames;
+    QVector<int> leafBegin; // Signals of leaf l: leafSignals[leafBegin[l] .. leafBegin[l + 1])
+    QVector<SignalHandle> leafSignals;
+    QVector<quint32> signalLeaf;
+    QHash<quint64, QVector<quint32>> leafTrigrams; // Trigram -> sorted leaf ids
+
+    // Lower-cased scope paths, plus the scope tree for their signal ranges
+    QVector<QString> scopePaths;
+    QVector<quint32> scopeParents;
+    QVector<int> scopeNameLength;
+    VCDScopeTree tree;
+};
+
+#endif // SIGNALNAMEINDEX_H
@@ -0,0 +1,226 @@
+#include "signalpatternsearch.h"
+#include "signalnameindex.h"
+#include <QtConcurrent>
+#include <QThreadPool>
+#include <QDebug>
+
+// Signals per shard; enough shards to keep every core busy, not so many that
+// merging dominates
+static const int MIN_SHARD_SIGNALS = 16384;
+static const int SHARDS_PER_THREAD = 4;
+
+// Cancellation is polled this often inside a shard
+static const int CANCEL_CHECK_INTERVAL = 1024;
+
+SignalPatternSearch::Syntax SignalPatternSearch::detectSyntax(const QString &text, QString *pattern)
+{
+    if (text.startsWith("re:"))
+    {
+        *pattern = text.mid(3);
+        return RegularExpression;
+    }
+
+    *pattern = text;
+    if (text.contains('*') || text.contains('?'))
+        return Wildcard;
+    return Substring;
+}
+
+// Anchored regex for a glob: '*' any run, '?' one character, [...] a class
+static QString wildcardToPattern(const QString &glob)
+{
+    QString rx = "^";
+    for (int i = 0; i < glob.size(); i++)
+    {
+        const QChar c = glob.at(i);
+        if (c == '*')
+        {
+            rx += ".*";
+        }
+        else if (c == '?')
+        {
+            rx += '.';
+        }
+        else if (c == '[' && glob.indexOf(']', i + 1) > i + 1)
+        {
+            int close = glob.indexOf(']', i + 1);
+            rx += glob.mid(i, close - i + 1);
+            i = close;
+        }
+        else
+        {
+            rx += QRegularExpression::escape(QString(c));
+        }
+    }
+    return rx + "$";
+}
+
+// Literal runs of a glob; each must appear somewhere in a matching name
+static QStringList wildcardFragments(const QString &glob)
+{
+    QStringList fragments;
+    QString current;
+    for (int i = 0; i < glob.size(); i++)
+    {
+        const QChar c = glob.at(i);
+        if (c == '*' || c == '?' || (c == '[' && glob.indexOf(']', i + 1) > i + 1))
+        {
+            if (!current.isEmpty())
+                fragments.append(current);
+            current.clear();
+            if (c == '[')
+                i = glob.indexOf(']', i + 1);
+        }
+        else
+        {
+            current += c;
+        }
+    }
+    if (!current.isEmpty())
+        fragments.append(current);
+    return fragments;
+}
+
+SignalPatternSearch::SignalPatternSearch(QObject *parent)
+    : QObject(parent), generation(0), pendingShards(0), totalShards(0)
+{
+}
+
+SignalPatternSearch::~SignalPatternSearch()
+{
+    // Shards post back to this object, so none may outlive it
+    cancel();
+    waitForShards();
+}
+
+void SignalPatternSearch::cancel()
+{
+    if (cancelToken)
+        cancelToken->storeRelease(1);
+    generation++;
+    pendingShards = 0;
+}
+
+void SignalPatternSearch::waitForShards()
+{
+    for (QFuture<void> &shard : shards)
+        shard.waitForFinished();
+    shards.clear();
+}
+
+bool SignalPatternSearch::start(const VCDParser *parser, const QString &text)
+{
+    cancel();
+
+    // Forget shards that are done; cancelled ones stop within a few microseconds
+    for (int i = shards.size() - 1; i >= 0; i--)
+    {
+        if (shards.at(i).isFinished())
+            shards.removeAt(i);
+    }
+
+    QString pattern;
+    Syntax syntax = detectSyntax(text, &pattern);
+
+    QRegularExpression regex(syntax == Wildcard ? wildcardToPattern(pattern) : pattern,
+                             QRegularExpression::CaseInsensitiveOption);
+    if (!regex.isValid())
+    {
+        error = QString("Invalid pattern: %1").arg(regex.errorString());
+        return false;
+    }
+    regex.optimize();
+    error.clear();
+
+    const int signalCount = parser->getSignalCount();
+    result = QBitArray(signalCount);
+
+    // Literal parts of a glob narrow the candidates through the name index
+    QBitArray candidates;
+    if (syntax == Wildcard)
+    {
+        for (const QString &fragment : wildcardFragments(pattern))
+        {
+            QBitArray matches = parser->getNameIndex().search(fragment);
+            if (candidates.isEmpty())
+                candidates = matches;
+            else
+                candidates &= matches;
+        }
+    }
+
+    // Scope paths once, parent first, shared read-only by the shards
+    QVector<QString> scopePaths(parser->getScopeCount());
+    for (int s = 1; s < scopePaths.size(); s++)
+    {
+        const QString &parentPath = scopePaths.at(parser->getScopeParent(s));
+        scopePaths[s] = parentPath.isEmpty() ? parser->getScopeName(s) : parentPath + "." + parser->getScopeName(s);
+    }
+
+    // Scope and leaf name of every signal, copied here too: the parser's
+    // tables may be rewritten (RTL directions, a reload) while shards run
+    QVector<quint32> signalScopes(signalCount);
+    QVector<QString> signalNames(signalCount);
+    for (int h = 0; h < signalCount; h++)
+    {
+        signalScopes[h] = parser->getSignalScope(h);
+        signalNames[h] = parser->getSignalName(h);
+    }
+
+    const int threads = qMax(1, QThreadPool::globalInstance()->maxThreadCount());
+    const int shardSize = qMax(MIN_SHARD_SIGNALS, signalCount / (threads * SHARDS_PER_THREAD) + 1);
+
+    cancelToken = QSharedPointer<QAtomicInt>(new QAtomicInt(0));
+    const int searchGeneration = generation;
+    totalShards = (signalCount + shardSize - 1) / shardSize;
+    pendingShards = totalShards;
+
+    if (totalShards == 0)
+    {
+        emit finished(result);
+        return true;
+    }
+
+    for (int begin = 0; begin < signalCount; begin += shardSize)
+    {
+        const int end = qMin(signalCount, begin + shardSize);
+        QSharedPointer<QAtomicInt> token = cancelToken;
+
+        shards.append(QtConcurrent::run([this, regex, scopePaths, signalScopes, signalNames, candidates, token, searchGeneration, begin, end]() {
+            QVector<SignalHandle> matches;
+            for (int h = begin; h < end; h++)
+            {
+                if ((h - begin) % CANCEL_CHECK_INTERVAL == 0 && token->loadAcquire())
+                    return;
+                if (!candidates.isEmpty() && !candidates.testBit(h))
+                    continue;
+
+                const QString &path = scopePaths.at(signalScopes.at(h));
+                const QString &name = signalNames.at(h);
+                if (regex.match(path.isEmpty() ? name : path + "." + name).hasMatch())
+                    matches.append(h);
+            }
+
+            QMetaObject::invokeMethod(this, [this, searchGeneration, matches]() {
+                mergeShard(searchGeneration, matches);
+            }, Qt::QueuedConnection);
+        }));
+    }
+
+    qDebug() << "Pattern search started:" << text << totalShards << "shards";
+    return true;
+}
+
+void SignalPatternSearch::mergeShard(int shardGeneration, const QVector<SignalHandle> &matches)
+{
+    if (shardGeneration != generation)
+        return; // From a cancelled search
+
+    for (SignalHandle handle : matches)
+        result.setBit(handle);
+
+    pendingShards--;
+    emit progress(result, totalShards - pendingShards, totalShards);
+    if (pendingShards == 0)
+        emit finished(result);
+}
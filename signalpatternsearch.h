@@ -0,0 +1,53 @@
+#ifndef SIGNALPATTERNSEARCH_H
+#define SIGNALPATTERNSEARCH_H
+
+#include <QObject>
+#include <QBitArray>
+#include <QFuture>
+#include <QList>
+#include <QRegularExpression>
+#include <QSharedPointer>
+#include <QAtomicInt>
+#include "vcdparser.h"
+
+// Glob ("*.u_core*.*_valid") and regular expression ("re:...") matching of
+// full signal names. The signal table is split into shards that run on the
+// global thread pool; each finished shard is merged on the GUI thread and
+// reported, so large searches fill in progressively. Starting a new search
+// or destroying the object cancels the running one.
+class SignalPatternSearch : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Syntax { Substring, Wildcard, RegularExpression };
+
+    // Syntax of a search box entry; pattern receives the text to compile
+    static Syntax detectSyntax(const QString &text, QString *pattern);
+
+    explicit SignalPatternSearch(QObject *parent = nullptr);
+    ~SignalPatternSearch();
+
+    bool start(const VCDParser *parser, const QString &text);
+    void cancel();
+    bool isRunning() const { return pendingShards > 0; }
+    QString errorString() const { return error; }
+
+signals:
+    void progress(const QBitArray &matches, int shardsDone, int shardsTotal);
+    void finished(const QBitArray &matches);
+
+private:
+    void mergeShard(int shardGeneration, const QVector<SignalHandle> &matches);
+    void waitForShards();
+
+    QString error;
+    int generation;
+    int pendingShards;
+    int totalShards;
+    QBitArray result;
+    QSharedPointer<QAtomicInt> cancelToken;
+    QList<QFuture<void>> shards;
+};
+
+#endif // SIGNALPATTERNSEARCH_H
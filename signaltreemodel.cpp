@@ -0,0 +1,555 @@
+#include "signaltreemodel.h"
+#include <QTimer>
+
+// internalId() of a signal row is its position in signalRows with this bit set;
+// a scope row stores the scope index itself
+static const quintptr SIGNAL_ROW_TAG = 0x80000000u;
+
+// Rows exposed per fetchMore() call, and at most this many per pass of the
+// event loop whatever the view asks for
+static const int FETCH_BATCH_ROWS = 500;
+static const int MAX_ROWS_PER_FRAME = 2000;
+
+// fetchedRows key of the invisible root
+static const quint32 ROOT_FETCH_KEY = 0xFFFFFFFFu;
+
+static inline quint32 fetchKey(const QModelIndex &parent)
+{
+    return parent.isValid() ? quint32(parent.internalId()) : ROOT_FETCH_KEY;
+}
+
+SignalTreeModel::SignalTreeModel(QObject *parent)
+    : QAbstractItemModel(parent), parser(nullptr), rowsFetchedThisFrame(0), frameResetQueued(false),
+      deferredFetchPending(false), deferredFetchIsRoot(false), selectedTotal(0)
+{
+    rebuild();
+}
+
+void SignalTreeModel::setParser(const VCDParser *parser)
+{
+    beginResetModel();
+    this->parser = parser;
+    mask.clear();
+    selected = QBitArray(parser ? parser->getSignalCount() : 0);
+    selectedTotal = 0;
+    rebuild();
+    endResetModel();
+}
+
+void SignalTreeModel::setVisibleMask(const QBitArray &mask)
+{
+    beginResetModel();
+    this->mask = mask;
+    rebuild();
+    endResetModel();
+}
+
+void SignalTreeModel::rebuild()
+{
+    fetchedRows.clear();
+    deferredFetchPending = false;
+
+    if (!parser)
+    {
+        // Just an empty root
+        childBegin = {0, 0};
+        childScopes.clear();
+        scopeRow = {0};
+        signalBegin = {0};
+        signalEnd = {0};
+        subtreeEnd = {0};
+        signalRows.clear();
+        scopePreorder = {0};
+        recountSelection();
+        return;
+    }
+
+    const VCDScopeTree &tree = parser->getScopeTree();
+    const int scopeCount = tree.signalBegin.size();
+
+    // Parents before children, siblings in declaration order: the order
+    // signals are laid out in, so every subtree is one range of rows
+    scopePreorder.clear();
+    scopePreorder.reserve(scopeCount);
+    QVector<quint32> pending;
+    pending.append(0);
+    while (!pending.isEmpty())
+    {
+        quint32 scope = pending.takeLast();
+        scopePreorder.append(scope);
+        for (int i = tree.childBegin[scope + 1] - 1; i >= tree.childBegin[scope]; i--)
+            pending.append(tree.childScopes[i]);
+    }
+
+    // The whole design: the parser's layout is used as it is
+    if (mask.isEmpty())
+    {
+        childBegin = tree.childBegin;
+        childScopes = tree.childScopes;
+        scopeRow = tree.childRow;
+        signalBegin = tree.signalBegin;
+        signalEnd = tree.signalEnd;
+        subtreeEnd = tree.subtreeEnd;
+        signalRows = tree.signalOrder;
+        recountSelection();
+        return;
+    }
+
+    // Visible signals per scope, then per subtree
+    QVector<int> ownCount(scopeCount, 0);
+    for (int s = 0; s < scopeCount; s++)
+    {
+        for (int i = tree.signalBegin[s]; i < tree.signalEnd[s]; i++)
+        {
+            if (mask.testBit(tree.signalOrder[i]))
+                ownCount[s]++;
+        }
+    }
+
+    QVector<int> subtreeCount = ownCount;
+    for (int k = scopePreorder.size() - 1; k > 0; k--)
+    {
+        quint32 scope = scopePreorder[k];
+        subtreeCount[parser->getScopeParent(scope)] += subtreeCount[scope];
+    }
+
+    // Keep the non-empty children of each scope, in declaration order
+    childBegin.resize(scopeCount + 1);
+    childScopes.clear();
+    scopeRow.fill(-1, scopeCount);
+    for (int s = 0; s < scopeCount; s++)
+    {
+        childBegin[s] = childScopes.size();
+        for (int i = tree.childBegin[s]; i < tree.childBegin[s + 1]; i++)
+        {
+            quint32 child = tree.childScopes[i];
+            if (subtreeCount[child] > 0)
+            {
+                scopeRow[child] = childScopes.size() - childBegin[s];
+                childScopes.append(child);
+            }
+        }
+    }
+    childBegin[scopeCount] = childScopes.size();
+
+    signalBegin.resize(scopeCount);
+    signalEnd.resize(scopeCount);
+    subtreeEnd.resize(scopeCount);
+    signalRows.clear();
+    signalRows.reserve(subtreeCount.isEmpty() ? 0 : subtreeCount[0]);
+    for (quint32 scope : scopePreorder)
+    {
+        signalBegin[scope] = signalRows.size();
+        for (int i = tree.signalBegin[scope]; i < tree.signalEnd[scope]; i++)
+        {
+            if (mask.testBit(tree.signalOrder[i]))
+                signalRows.append(tree.signalOrder[i]);
+        }
+        signalEnd[scope] = signalRows.size();
+        subtreeEnd[scope] = signalBegin[scope] + subtreeCount[scope];
+    }
+
+    recountSelection();
+}
+
+// Selected visible signals of every scope and subtree, from scratch
+void SignalTreeModel::recountSelection()
+{
+    const int scopeCount = signalBegin.size();
+    ownSelected.fill(0, scopeCount);
+    for (int s = 0; s < scopeCount; s++)
+    {
+        for (int i = signalBegin[s]; i < signalEnd[s]; i++)
+        {
+            if (selected.testBit(signalRows[i]))
+                ownSelected[s]++;
+        }
+    }
+
+    subtreeSelected = ownSelected;
+    for (int k = scopePreorder.size() - 1; k > 0; k--)
+    {
+        quint32 scope = scopePreorder[k];
+        subtreeSelected[parser->getScopeParent(scope)] += subtreeSelected[scope];
+    }
+}
+
+bool SignalTreeModel::isSignalIndex(const QModelIndex &index) const
+{
+    return index.isValid() && (index.internalId() & SIGNAL_ROW_TAG);
+}
+
+SignalHandle SignalTreeModel::signalHandle(const QModelIndex &index) const
+{
+    if (!isSignalIndex(index))
+        return InvalidSignalHandle;
+    return signalRows.at(int(index.internalId() & ~SIGNAL_ROW_TAG));
+}
+
+QModelIndex SignalTreeModel::scopeIndex(quint32 scope) const
+{
+    if (scope == 0)
+        return createIndex(0, 0, quintptr(0));
+
+    int row = scopeRow.at(scope);
+    if (parser->getScopeParent(scope) == 0 && showsGlobalRow())
+        row++;
+    return createIndex(row, 0, quintptr(scope));
+}
+
+QModelIndex SignalTreeModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (!hasIndex(row, column, parent))
+        return QModelIndex();
+
+    if (!parent.isValid())
+    {
+        int childRow = row;
+        if (showsGlobalRow())
+        {
+            if (row == 0)
+                return createIndex(row, column, quintptr(0));
+            childRow--;
+        }
+        return createIndex(row, column, quintptr(childScopes.at(childBegin[0] + childRow)));
+    }
+
+    quint32 scope = quint32(parent.internalId());
+    if (scope == 0)
+        return createIndex(row, column, quintptr(signalBegin[0] + row) | SIGNAL_ROW_TAG);
+
+    // Child scopes first, then the scope's own signals
+    int scopes = childScopeCount(scope);
+    if (row < scopes)
+        return createIndex(row, column, quintptr(childScopes.at(childBegin[scope] + row)));
+    return createIndex(row, column, quintptr(signalBegin[scope] + row - scopes) | SIGNAL_ROW_TAG);
+}
+
+QModelIndex SignalTreeModel::parent(const QModelIndex &child) const
+{
+    if (!child.isValid())
+        return QModelIndex();
+
+    if (isSignalIndex(child))
+        return scopeIndex(parser->getSignalScope(signalHandle(child)));
+
+    quint32 scope = quint32(child.internalId());
+    if (scope == 0)
+        return QModelIndex();
+
+    quint32 parentScope = parser->getScopeParent(scope);
+    if (parentScope == 0)
+        return QModelIndex();
+    return scopeIndex(parentScope);
+}
+
+int SignalTreeModel::rowCount(const QModelIndex &parent) const
+{
+    int total = totalRowCount(parent);
+    return qMin(total, fetchedRows.value(fetchKey(parent), FETCH_BATCH_ROWS));
+}
+
+bool SignalTreeModel::canFetchMore(const QModelIndex &parent) const
+{
+    return rowCount(parent) < totalRowCount(parent);
+}
+
+void SignalTreeModel::fetchMore(const QModelIndex &parent)
+{
+    const int have = rowCount(parent);
+    const int total = totalRowCount(parent);
+    if (have >= total)
+        return;
+
+    if (rowsFetchedThisFrame >= MAX_ROWS_PER_FRAME)
+    {
+        // Over budget: let the view paint, then continue where it asked
+        deferredFetchPending = true;
+        deferredFetchIsRoot = !parent.isValid();
+        deferredFetch = parent;
+        scheduleFrameReset();
+        return;
+    }
+
+    const int count = qMin(qMin(FETCH_BATCH_ROWS, MAX_ROWS_PER_FRAME - rowsFetchedThisFrame), total - have);
+    beginInsertRows(parent, have, have + count - 1);
+    fetchedRows[fetchKey(parent)] = have + count;
+    endInsertRows();
+
+    rowsFetchedThisFrame += count;
+    scheduleFrameReset();
+}
+
+void SignalTreeModel::scheduleFrameReset()
+{
+    if (frameResetQueued)
+        return;
+    frameResetQueued = true;
+
+    QTimer::singleShot(0, this, [this]() {
+        frameResetQueued = false;
+        rowsFetchedThisFrame = 0;
+
+        if (deferredFetchPending)
+        {
+            deferredFetchPending = false;
+            QModelIndex parent = deferredFetch;
+            if (deferredFetchIsRoot || parent.isValid())
+                fetchMore(parent);
+        }
+    });
+}
+
+int SignalTreeModel::totalRowCount(const QModelIndex &parent) const
+{
+    if (!parent.isValid())
+        return (showsGlobalRow() ? 1 : 0) + childScopeCount(0);
+
+    if (parent.column() != 0 || isSignalIndex(parent))
+        return 0;
+
+    quint32 scope = quint32(parent.internalId());
+    if (scope == 0)
+        return scopeSignalCount(0);
+    return childScopeCount(scope) + scopeSignalCount(scope);
+}
+
+int SignalTreeModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return 4;
+}
+
+QVariant SignalTreeModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || !parser)
+        return QVariant();
+
+    if (isSignalIndex(index))
+    {
+        SignalHandle handle = signalHandle(index);
+        if (role == Qt::DisplayRole)
+        {
+            switch (index.column())
+            {
+            case 0: return parser->getSignalName(handle);
+            case 1: return parser->getSignalWidth(handle);
+            case 2: return parser->getSignalType(handle);
+            case 3: return parser->getSignalIdentifier(handle);
+            }
+        }
+        else if (role == Qt::ToolTipRole)
+        {
+            return parser->getFullName(handle);
+        }
+        else if (role == Qt::CheckStateRole && index.column() == 0)
+        {
+            return isSelected(handle) ? Qt::Checked : Qt::Unchecked;
+        }
+        return QVariant();
+    }
+
+    quint32 scope = quint32(index.internalId());
+    if (index.column() != 0)
+        return QVariant();
+
+    if (role == Qt::DisplayRole)
+        return scope == 0 ? QString("Global Signals") : parser->getScopeName(scope);
+    if (role == Qt::ToolTipRole && scope != 0)
+        return parser->getScopePath(scope);
+    if (role == Qt::CheckStateRole)
+        return scopeCheckState(scope);
+    return QVariant();
+}
+
+bool SignalTreeModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (!index.isValid() || role != Qt::CheckStateRole || index.column() != 0)
+        return false;
+
+    bool select = value.toInt() == Qt::Checked;
+    if (isSignalIndex(index))
+        setSelected(signalHandle(index), select);
+    else
+        setScopeSelected(quint32(index.internalId()), select);
+    return true;
+}
+
+Qt::ItemFlags SignalTreeModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid())
+        return Qt::NoItemFlags;
+
+    Qt::ItemFlags result = Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+    if (index.column() == 0)
+        result |= Qt::ItemIsUserCheckable;
+    return result;
+}
+
+QVariant SignalTreeModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return QVariant();
+
+    switch (section)
+    {
+    case 0: return QString("Signal");
+    case 1: return QString("Width");
+    case 2: return QString("Type");
+    case 3: return QString("Identifier");
+    }
+    return QVariant();
+}
+
+bool SignalTreeModel::isVisibleSignal(SignalHandle handle) const
+{
+    return parser && (mask.isEmpty() || mask.testBit(handle));
+}
+
+// Flips one signal and keeps the counts of its scope and ancestors in step
+void SignalTreeModel::updateSelected(SignalHandle handle, bool select)
+{
+    if (selected.testBit(handle) == select)
+        return;
+
+    selected.setBit(handle, select);
+    const int delta = select ? 1 : -1;
+    selectedTotal += delta;
+
+    if (!isVisibleSignal(handle))
+        return;
+
+    quint32 scope = parser->getSignalScope(handle);
+    ownSelected[scope] += delta;
+    for (;;)
+    {
+        subtreeSelected[scope] += delta;
+        if (scope == 0)
+            break;
+        scope = parser->getScopeParent(scope);
+    }
+}
+
+void SignalTreeModel::setSelected(SignalHandle handle, bool select)
+{
+    updateSelected(handle, select);
+    notifyCheckStates();
+}
+
+void SignalTreeModel::setSelected(const QVector<SignalHandle> &handles, bool select)
+{
+    for (SignalHandle handle : handles)
+        updateSelected(handle, select);
+    notifyCheckStates();
+}
+
+void SignalTreeModel::setScopeSelected(quint32 scope, bool select)
+{
+    // The "Global Signals" row covers only the root's own signals; any other
+    // scope is one contiguous range of rows with its whole subtree
+    const int end = scope == 0 ? signalEnd[0] : subtreeEnd[scope];
+    int delta = 0;
+    for (int i = signalBegin[scope]; i < end; i++)
+    {
+        SignalHandle handle = signalRows[i];
+        if (selected.testBit(handle) != select)
+        {
+            selected.setBit(handle, select);
+            delta += select ? 1 : -1;
+        }
+    }
+    selectedTotal += delta;
+
+    if (scope == 0)
+    {
+        ownSelected[0] = select ? scopeSignalCount(0) : 0;
+        subtreeSelected[0] += delta;
+    }
+    else
+    {
+        // Every visible scope below is now all or nothing
+        QVector<quint32> pending;
+        pending.append(scope);
+        while (!pending.isEmpty())
+        {
+            quint32 current = pending.takeLast();
+            ownSelected[current] = select ? scopeSignalCount(current) : 0;
+            subtreeSelected[current] = select ? subtreeEnd[current] - signalBegin[current] : 0;
+            for (int i = childBegin[current]; i < childBegin[current + 1]; i++)
+                pending.append(childScopes[i]);
+        }
+
+        for (quint32 ancestor = parser->getScopeParent(scope);; ancestor = parser->getScopeParent(ancestor))
+        {
+            subtreeSelected[ancestor] += delta;
+            if (ancestor == 0)
+                break;
+        }
+    }
+
+    notifyCheckStates();
+}
+
+void SignalTreeModel::setVisibleSelected(bool select)
+{
+    for (SignalHandle handle : signalRows)
+    {
+        if (selected.testBit(handle) != select)
+        {
+            selected.setBit(handle, select);
+            selectedTotal += select ? 1 : -1;
+        }
+    }
+    recountSelection();
+    notifyCheckStates();
+}
+
+void SignalTreeModel::clearSelection()
+{
+    selected.fill(false);
+    selectedTotal = 0;
+    recountSelection();
+    notifyCheckStates();
+}
+
+QVector<SignalHandle> SignalTreeModel::selectedHandles() const
+{
+    QVector<SignalHandle> handles;
+    handles.reserve(selectedTotal);
+    for (int h = 0; h < selected.size(); h++)
+    {
+        if (selected.testBit(h))
+            handles.append(h);
+    }
+    return handles;
+}
+
+Qt::CheckState SignalTreeModel::scopeCheckState(quint32 scope) const
+{
+    int total;
+    int selectedInScope;
+    if (scope == 0)
+    {
+        total = scopeSignalCount(0);
+        selectedInScope = ownSelected[0];
+    }
+    else
+    {
+        total = subtreeEnd[scope] - signalBegin[scope];
+        selectedInScope = subtreeSelected[scope];
+    }
+
+    if (total == 0 || selectedInScope == 0)
+        return Qt::Unchecked;
+    return selectedInScope == total ? Qt::Checked : Qt::PartiallyChecked;
+}
+
+void SignalTreeModel::notifyCheckStates()
+{
+    // Scope states depend on every descendant; the view repaints whatever
+    // rows are on screen and reads the counts again
+    int rows = rowCount();
+    if (rows > 0)
+        emit dataChanged(index(0, 0), index(rows - 1, 0), {Qt::CheckStateRole});
+    emit selectionChanged();
+}
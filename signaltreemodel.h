@@ -0,0 +1,105 @@
+#ifndef SIGNALTREEMODEL_H
+#define SIGNALTREEMODEL_H
+
+#include <QAbstractItemModel>
+#include <QBitArray>
+#include <QHash>
+#include <QVector>
+#include <QPersistentModelIndex>
+#include "vcdparser.h"
+
+// Scope/signal tree for the signal selection dialog, read straight from the
+// parser's header table and scope tree. Rows are positions in flat child
+// arrays, so no object is created per scope or signal however large the
+// design is. Rows are handed to the view in pages through fetchMore(), so
+// expanding a scope with hundreds of thousands of nets stays responsive.
+class SignalTreeModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    explicit SignalTreeModel(QObject *parent = nullptr);
+
+    void setParser(const VCDParser *parser);
+
+    // Only signals set in the mask are shown, and scopes left empty are hidden
+    void setVisibleMask(const QBitArray &mask);
+    int visibleSignalCount() const { return signalRows.size(); }
+
+    bool isSignalIndex(const QModelIndex &index) const;
+    SignalHandle signalHandle(const QModelIndex &index) const;
+
+    // Selection (check state) of individual signals and whole scopes
+    bool isSelected(SignalHandle handle) const { return selected.testBit(handle); }
+    void setSelected(SignalHandle handle, bool select);
+    void setSelected(const QVector<SignalHandle> &handles, bool select);
+    void setVisibleSelected(bool select);
+    void clearSelection();
+    int selectedCount() const { return selectedTotal; }
+    QVector<SignalHandle> selectedHandles() const;
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+signals:
+    void selectionChanged();
+
+private:
+    void rebuild();
+    QModelIndex scopeIndex(quint32 scope) const;
+    int childScopeCount(quint32 scope) const { return childBegin[scope + 1] - childBegin[scope]; }
+    int scopeSignalCount(quint32 scope) const { return signalEnd[scope] - signalBegin[scope]; }
+    bool showsGlobalRow() const { return scopeSignalCount(0) > 0; }
+    void setScopeSelected(quint32 scope, bool select);
+    void updateSelected(SignalHandle handle, bool select);
+    bool isVisibleSignal(SignalHandle handle) const;
+    void recountSelection();
+    Qt::CheckState scopeCheckState(quint32 scope) const;
+    void notifyCheckStates();
+    int totalRowCount(const QModelIndex &parent) const;
+    void scheduleFrameReset();
+
+    const VCDParser *parser;
+    QBitArray mask;
+
+    // Visible tree in the parser's VCDScopeTree layout: the children of scope
+    // s are childScopes[childBegin[s] .. childBegin[s + 1]) and its signals
+    // are signalRows[signalBegin[s] .. signalEnd[s]), and with all its
+    // descendants signalRows[signalBegin[s] .. subtreeEnd[s]). Without a mask
+    // these share the parser's arrays. Scope 0 (the root) appears as a
+    // "Global Signals" row when it has signals of its own.
+    QVector<int> childBegin;
+    QVector<quint32> childScopes;
+    QVector<int> signalBegin;
+    QVector<int> signalEnd;
+    QVector<int> subtreeEnd;
+    QVector<quint32> scopePreorder;
+    QVector<SignalHandle> signalRows;
+    QVector<int> scopeRow; // Row of each visible scope under its parent
+
+    // Rows already exposed per parent (scope index, ~0u for the invalid root);
+    // parents not listed show their first page
+    QHash<quint32, int> fetchedRows;
+    int rowsFetchedThisFrame;
+    bool frameResetQueued;
+    bool deferredFetchPending;
+    bool deferredFetchIsRoot;
+    QPersistentModelIndex deferredFetch;
+
+    // Selection over every signal of the parser, visible or not, plus the
+    // selected visible signals per scope and per subtree for O(1) tri-states
+    QBitArray selected;
+    int selectedTotal;
+    QVector<int> ownSelected;
+    QVector<int> subtreeSelected;
+};
+
+#endif // SIGNALTREEMODEL_H
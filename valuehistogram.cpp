@@ -0,0 +1,77 @@
+#include "valuehistogram.h"
+#include "vcdparser.h"
+
+static void appendVarint(QByteArray &bytes, quint32 value)
+{
+    while (value >= 0x80)
+    {
+        bytes.append(char((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    bytes.append(char(value));
+}
+
+QSharedPointer<const ValueHistogram> ValueHistogram::build(const QVector<VCDValueChange> &changes, int endTime)
+{
+    QSharedPointer<ValueHistogram> histogram(new ValueHistogram);
+
+    for (int i = 0; i < changes.size(); i++)
+    {
+        const int time = i == 0 ? 0 : changes[i].timestamp;
+        const int until = i + 1 < changes.size() ? changes[i + 1].timestamp : qMax(endTime, time);
+
+        auto it = histogram->buckets.find(changes[i].value);
+        if (it == histogram->buckets.end())
+        {
+            if (histogram->buckets.size() >= MAX_DISTINCT_VALUES)
+            {
+                return QSharedPointer<const ValueHistogram>(); // Not a low-cardinality bus
+            }
+            it = histogram->buckets.insert(changes[i].value, Bucket());
+        }
+
+        Bucket &bucket = it.value();
+        appendVarint(bucket.times, quint32(time - bucket.lastTime));
+        bucket.lastTime = time;
+        bucket.count++;
+        bucket.duration += until - time;
+        histogram->total += until - time;
+    }
+
+    for (Bucket &bucket : histogram->buckets)
+    {
+        bucket.times.squeeze();
+    }
+    return histogram;
+}
+
+QVector<int> ValueHistogram::times(const QString &value) const
+{
+    QVector<int> result;
+    const auto it = buckets.constFind(value);
+    if (it == buckets.constEnd())
+    {
+        return result;
+    }
+
+    result.reserve(it->count);
+    const QByteArray &bytes = it->times;
+    int time = 0;
+    quint32 delta = 0;
+    int shift = 0;
+    for (int i = 0; i < bytes.size(); i++)
+    {
+        const quint8 byte = quint8(bytes[i]);
+        delta |= quint32(byte & 0x7F) << shift;
+        if (byte & 0x80)
+        {
+            shift += 7;
+            continue;
+        }
+        time += int(delta);
+        result.append(time);
+        delta = 0;
+        shift = 0;
+    }
+    return result;
+}
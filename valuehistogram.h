@@ -0,0 +1,50 @@
+#ifndef VALUEHISTOGRAM_H
+#define VALUEHISTOGRAM_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QVector>
+#include <QByteArray>
+#include <QSharedPointer>
+
+struct VCDValueChange;
+
+// NEW: Distinct values of one bus with the times each is entered, for buses
+// with few distinct values (FSM states, opcodes). A value search tests each
+// distinct value once and reads its times back instead of scanning every
+// change, and the same table gives value frequencies. Times are kept as
+// varint deltas, and no longer depend on the change data, so a histogram
+// outlives eviction of the signal it was built from.
+class ValueHistogram
+{
+public:
+    // Buses with more distinct values than this get no histogram
+    static const int MAX_DISTINCT_VALUES = 256;
+
+    // Null when the signal has too many distinct values. The initial value
+    // counts from time 0, as in value search; 'endTime' closes the last one.
+    static QSharedPointer<const ValueHistogram> build(const QVector<VCDValueChange> &changes, int endTime);
+
+    QStringList values() const { return buckets.keys(); }
+    int occurrences(const QString &value) const { return buckets.value(value).count; }
+    qint64 duration(const QString &value) const { return buckets.value(value).duration; }
+    qint64 totalDuration() const { return total; }
+
+    // Times the value is entered, ascending
+    QVector<int> times(const QString &value) const;
+
+private:
+    struct Bucket
+    {
+        QByteArray times; // Varint deltas
+        int count = 0;
+        int lastTime = 0;
+        qint64 duration = 0; // Time spent in the value
+    };
+
+    QHash<QString, Bucket> buckets;
+    qint64 total = 0;
+};
+
+#endif // VALUEHISTOGRAM_H
@@ -0,0 +1,329 @@
+#include "valuepattern.h"
+#include "vcdparser.h"
+#include <QStringList>
+
+ValuePattern::ValuePattern()
+    : special(false)
+{
+}
+
+// Multiply the little-endian words by 'factor' and add 'digit'
+static void multiplyAdd(QVector<quint64> &words, quint32 factor, quint32 digit)
+{
+    quint64 carry = digit;
+    for (quint64 &word : words)
+    {
+        const quint64 low = (word & 0xFFFFFFFFu) * factor + carry;
+        const quint64 high = (word >> 32) * factor + (low >> 32);
+        word = (low & 0xFFFFFFFFu) | (high << 32);
+        carry = high >> 32;
+    }
+    if (carry)
+    {
+        words.append(carry);
+    }
+}
+
+static quint64 wordAt(const QVector<quint64> &words, int i, quint64 above = 0)
+{
+    return i < words.size() ? words[i] : above;
+}
+
+bool ValuePattern::compile(const QString &text, int format)
+{
+    literal = text.trimmed().toLower();
+    special = (literal == "x" || literal == "z");
+    terms.clear();
+    error.clear();
+
+    if (literal.isEmpty())
+    {
+        error = "Empty search value";
+        return false;
+    }
+    if (special)
+    {
+        return true;
+    }
+
+    for (const QString &part : literal.split("&&"))
+    {
+        Term term;
+        if (!parseTerm(part.trimmed(), format, &term))
+        {
+            terms.clear();
+            return false;
+        }
+        terms.append(term);
+    }
+    return true;
+}
+
+bool ValuePattern::parseTerm(const QString &text, int format, Term *term)
+{
+    static const struct
+    {
+        const char *token;
+        Op op;
+    } operators[] = {{">=", GreaterEqual}, {"<=", LessEqual}, {"!=", NotEqual},
+                     {"==", Equal},        {">", Greater},     {"<", Less}};
+
+    QString rest = text;
+    for (const auto &candidate : operators)
+    {
+        if (rest.startsWith(QLatin1String(candidate.token)))
+        {
+            term->op = candidate.op;
+            rest = rest.mid(int(qstrlen(candidate.token))).trimmed();
+            break;
+        }
+    }
+
+    const int base = format == Binary ? 2 : format == Decimal ? 10 : format == Octal ? 8 : 16;
+    const int slash = rest.indexOf('/');
+    const QString numberText = (slash < 0 ? rest : rest.left(slash)).trimmed();
+
+    QVector<quint64> ignored;
+    if (!parseNumber(numberText, base, &term->value, &ignored))
+    {
+        return false;
+    }
+
+    // Bits left out by '?' digits and, with "/mask", everything outside it
+    QVector<quint64> care;
+    quint64 careAbove = ~quint64(0);
+    if (slash >= 0)
+    {
+        QVector<quint64> maskIgnored;
+        if (!parseNumber(rest.mid(slash + 1).trimmed(), base, &care, &maskIgnored))
+        {
+            return false;
+        }
+        if (!maskIgnored.isEmpty())
+        {
+            error = "A mask cannot contain '?'";
+            return false;
+        }
+        careAbove = 0;
+    }
+
+    const int words = qMax(care.size(), ignored.size());
+    if (words > 0 || slash >= 0)
+    {
+        if (term->op != Equal && term->op != NotEqual)
+        {
+            error = "Wildcards and masks only work with == and !=";
+            return false;
+        }
+
+        term->mask.resize(words);
+        for (int i = 0; i < words; i++)
+        {
+            term->mask[i] = wordAt(care, i, careAbove) & ~wordAt(ignored, i);
+        }
+        term->maskAbove = careAbove;
+    }
+    return true;
+}
+
+bool ValuePattern::parseNumber(const QString &text, int base, QVector<quint64> *value, QVector<quint64> *ignored)
+{
+    // Same prefixes the dialog documents
+    QString digits = text;
+    if (base == 16 && digits.startsWith("0x"))
+        digits = digits.mid(2);
+    else if (base == 8 && digits.startsWith("0o"))
+        digits = digits.mid(2);
+    else if (base == 2 && digits.startsWith('b'))
+        digits = digits.mid(1);
+    else if (base == 10 && digits.startsWith('d'))
+        digits = digits.mid(1);
+    digits.remove('_');
+
+    if (digits.isEmpty())
+    {
+        error = QString("'%1' has no digits").arg(text);
+        return false;
+    }
+
+    value->fill(0, 1);
+    ignored->clear();
+    bool wildcard = false;
+    QVector<quint64> wild(1, 0);
+
+    for (const QChar ch : digits)
+    {
+        if (ch == QLatin1Char('?'))
+        {
+            if (base == 10)
+            {
+                error = "'?' needs a binary, octal or hex value";
+                return false;
+            }
+            wildcard = true;
+            multiplyAdd(*value, base, 0);
+            multiplyAdd(wild, base, base - 1);
+            continue;
+        }
+
+        const ushort c = ch.unicode();
+        const int digit = ch.isDigit() ? ch.digitValue() : (c >= 'a' && c <= 'f') ? c - 'a' + 10 : 99;
+        if (digit >= base)
+        {
+            error = QString("'%1' is not a valid digit for this format").arg(ch);
+            return false;
+        }
+        multiplyAdd(*value, base, digit);
+        multiplyAdd(wild, base, 0);
+    }
+
+    if (wildcard)
+    {
+        *ignored = wild;
+    }
+    return true;
+}
+
+bool ValuePattern::pack(const QString &value, QVector<quint64> *bits, QVector<quint64> *unknown, bool *unknownAbove)
+{
+    const int size = value.size();
+    const int words = (size + 63) / 64;
+    bits->fill(0, words);
+    unknown->fill(0, words);
+
+    // Digits from the least significant end
+    for (int bit = 0; bit < size; bit++)
+    {
+        const ushort c = value.at(size - 1 - bit).unicode();
+        const quint64 flag = quint64(1) << (bit & 63);
+        switch (c)
+        {
+        case '0':
+            break;
+        case '1':
+            (*bits)[bit >> 6] |= flag;
+            break;
+        case 'x':
+        case 'X':
+        case 'z':
+        case 'Z':
+            (*unknown)[bit >> 6] |= flag;
+            break;
+        default:
+            return false; // A real, or not a value at all
+        }
+    }
+
+    // VCD left-extends a shortened value with 0, or with its x/z digit
+    const ushort msb = size > 0 ? value.at(0).toLower().unicode() : '0';
+    *unknownAbove = (msb == 'x' || msb == 'z');
+
+    // The extension also covers the bits above the top digit in its own word
+    if (*unknownAbove && (size & 63) != 0)
+    {
+        (*unknown)[words - 1] |= ~quint64(0) << (size & 63);
+    }
+    return true;
+}
+
+bool ValuePattern::matchesPacked(const QVector<quint64> &bits, const QVector<quint64> &unknown, bool unknownAbove) const
+{
+    const quint64 extension = unknownAbove ? ~quint64(0) : 0;
+
+    for (const Term &term : terms)
+    {
+        const int words = qMax(qMax(bits.size(), term.value.size()), term.mask.size());
+
+        if (term.op == Equal || term.op == NotEqual)
+        {
+            // Compare under the mask; an unknown bit the term looks at decides nothing
+            bool differ = false;
+            for (int i = 0; i < words; i++)
+            {
+                const quint64 mask = term.mask.isEmpty() ? ~quint64(0) : wordAt(term.mask, i, term.maskAbove);
+                if (wordAt(unknown, i, extension) & mask)
+                    return false;
+                if ((wordAt(bits, i) ^ wordAt(term.value, i)) & mask)
+                    differ = true;
+            }
+            if (unknownAbove && (term.mask.isEmpty() || term.maskAbove))
+                return false;
+            if (differ != (term.op == NotEqual))
+                return false;
+            continue;
+        }
+
+        // Ranges need a fully known value; compare from the top word down
+        if (unknownAbove)
+            return false;
+        int order = 0;
+        for (int i = words - 1; i >= 0; i--)
+        {
+            if (wordAt(unknown, i))
+                return false;
+            const quint64 a = wordAt(bits, i);
+            const quint64 b = wordAt(term.value, i);
+            if (order == 0 && a != b)
+                order = a < b ? -1 : 1;
+        }
+
+        bool holds = false;
+        switch (term.op)
+        {
+        case Less: holds = order < 0; break;
+        case LessEqual: holds = order <= 0; break;
+        case Greater: holds = order > 0; break;
+        case GreaterEqual: holds = order >= 0; break;
+        default: break;
+        }
+        if (!holds)
+            return false;
+    }
+    return true;
+}
+
+bool ValuePattern::matches(const QString &value, int width) const
+{
+    Q_UNUSED(width) // Bits above the width are zero in the packed value
+
+    // Exact text first: covers x/z and real values
+    if (value.compare(literal, Qt::CaseInsensitive) == 0)
+    {
+        return true;
+    }
+    if (special || terms.isEmpty())
+    {
+        return false;
+    }
+
+    QVector<quint64> bits;
+    QVector<quint64> unknown;
+    bool unknownAbove = false;
+    return pack(value, &bits, &unknown, &unknownAbove) && matchesPacked(bits, unknown, unknownAbove);
+}
+
+QVector<int> ValuePattern::scan(const QVector<VCDValueChange> &changes, int width) const
+{
+    Q_UNUSED(width)
+
+    // Scratch words reused for every change of the signal
+    QVector<quint64> bits;
+    QVector<quint64> unknown;
+    bool unknownAbove = false;
+
+    QVector<int> hits;
+    for (int i = 0; i < changes.size(); i++)
+    {
+        const QString &value = changes[i].value;
+        if (value.compare(literal, Qt::CaseInsensitive) == 0)
+        {
+            hits.append(i);
+        }
+        else if (!special && !terms.isEmpty() && pack(value, &bits, &unknown, &unknownAbove) &&
+                 matchesPacked(bits, unknown, unknownAbove))
+        {
+            hits.append(i);
+        }
+    }
+    return hits;
+}
@@ -0,0 +1,77 @@
+#ifndef VALUEPATTERN_H
+#define VALUEPATTERN_H
+
+#include <QString>
+#include <QVector>
+
+struct VCDValueChange;
+
+// A value search term compiled once into little-endian bit vectors, so
+// matching a change packs its binary digits into words once and compares
+// them word by word instead of parsing the search text and the value into
+// numbers for every comparison. Immutable after compile(), so one instance
+// is shared by parallel scans.
+//
+// Besides a plain number the term may hold:
+//   wildcards  0xDEAD_??EF, 10?1    '?' leaves a digit's bits out (not in decimal)
+//   masks      0x80/0xC0            compare only the bits set in the mask
+//   ranges     >= 0x8000_0000 && < 0x9000_0000
+// with ==, !=, <, <=, >, >= and any number of terms joined by &&.
+class ValuePattern
+{
+public:
+    // Same numbering as the value search dialog's format buttons
+    enum Format
+    {
+        Binary = 1,
+        Hex = 2,
+        Decimal = 3,
+        Octal = 4
+    };
+
+    ValuePattern();
+
+    bool compile(const QString &text, int format);
+    QString errorString() const { return error; }
+    QString text() const { return literal; }
+
+    // True when a stored value (binary digits, x/z, or a real) is the term
+    bool matches(const QString &value, int width) const;
+
+    // Indices of the changes whose value matches
+    QVector<int> scan(const QVector<VCDValueChange> &changes, int width) const;
+
+private:
+    enum Op
+    {
+        Equal,
+        NotEqual,
+        Less,
+        LessEqual,
+        Greater,
+        GreaterEqual
+    };
+
+    // One comparison; equality ops look at the bits in 'mask' only
+    struct Term
+    {
+        Op op = Equal;
+        QVector<quint64> value;
+        QVector<quint64> mask; // Empty: every bit
+        quint64 maskAbove = ~quint64(0); // Mask of the words past 'mask'
+    };
+
+    bool parseTerm(const QString &text, int format, Term *term);
+    bool parseNumber(const QString &text, int base, QVector<quint64> *value, QVector<quint64> *ignored);
+
+    // Value digits as words; false for anything but 0/1/x/z digits
+    static bool pack(const QString &value, QVector<quint64> *bits, QVector<quint64> *unknown, bool *unknownAbove);
+    bool matchesPacked(const QVector<quint64> &bits, const QVector<quint64> &unknown, bool unknownAbove) const;
+
+    QString literal;     // Trimmed, lowercase search text
+    bool special;        // "x" or "z": only literal matches
+    QVector<Term> terms; // All must hold
+    QString error;
+};
+
+#endif // VALUEPATTERN_H
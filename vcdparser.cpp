@@ -1,26 +1,521 @@
 #include "vcdparser.h"
+#include "signalcache.h"
+#include "signalnameindex.h"
+#include "signalexpression.h"
 #include <QRegularExpression>
+#include <QElapsedTimer>
+#include <QtConcurrent>
+#include <QThreadPool>
 #include <QDebug>
+#include <cstdio>
+#include <climits>
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+// Streamed value changes are handed to the GUI thread in batches
+static const int STREAM_BATCH_LINES = 50000;
+static const int STREAM_FLUSH_INTERVAL_MS = 200;
+
+// Over the memory budget, a stream drops its oldest changes down to this
+// share of the budget, so it does not trim again with every batch
+static const int STREAM_TRIM_PERCENT = 75;
+
+// A reader waiting for stream data checks for cancellation this often
+static const int STREAM_CANCEL_POLL_MS = 100;
+
+// Time-window seeking: bisect on "#time" lines until the remaining range is
+// small, remember some timestamps as checkpoints, and walk backwards in
+// blocks to find the value each signal holds at the window start
+static const qint64 WINDOW_LINEAR_SCAN_BYTES = 1024 * 1024;
+static const qint64 WINDOW_BACKSCAN_BYTES = 4 * 1024 * 1024;
+static const qint64 WINDOW_BACKSCAN_LIMIT_BYTES = 64 * 1024 * 1024; // Then replay from a value snapshot
+static const qint64 CHECKPOINT_SPACING_BYTES = 16 * 1024 * 1024;
+
+// Parallel loads give each pool thread a piece of at least this size
+static const qint64 MIN_LOAD_CHUNK_BYTES = 8 * 1024 * 1024;
+
+// "#1234" -> 1234
+static bool parseTimestampLine(const QString &line, int *timestamp)
+{
+    if (line.size() < 2 || line.at(0) != '#')
+        return false;
+
+    bool ok = false;
+    int value = line.mid(1).toInt(&ok);
+    if (ok)
+        *timestamp = value;
+    return ok;
+}
+
+// Scalar "1!", vector "b1010 !" and real "r1.5 !" changes
+static bool parseValueChangeLine(const QString &line, QString *value, QString *identifier)
+{
+    if (line.isEmpty())
+        return false;
+
+    const QChar first = line.at(0);
+    switch (first.unicode())
+    {
+    case '0':
+    case '1':
+    case 'x':
+    case 'X':
+    case 'z':
+    case 'Z':
+    {
+        // Shared constants: millions of scalar changes must not each allocate
+        static const QString scalarValues[] = {"0", "1", "X", "Z"};
+
+        if (line.size() < 2 || line.contains(' ') || line.contains('\t'))
+            return false;
+
+        const char c = first.toUpper().toLatin1();
+        *value = scalarValues[c == '0' ? 0 : c == '1' ? 1 : c == 'X' ? 2 : 3];
+        *identifier = line.mid(1);
+        return true;
+    }
+    case 'b':
+    case 'B':
+    case 'r':
+    case 'R':
+    {
+        int space = 1;
+        while (space < line.size() && !line.at(space).isSpace())
+            space++;
+        if (space < 2 || space >= line.size())
+            return false;
+        *value = line.mid(1, space - 1);
+        *identifier = line.mid(space + 1).trimmed();
+        return !identifier->isEmpty();
+    }
+    default:
+        return false;
+    }
+}
+
+// Opens stdin ("-") or a named pipe. On Unix a pipe is opened without
+// waiting for a writer, and reads wait in waitForStreamData() instead, so a
+// stream nobody ever writes to can still be cancelled.
+static bool openStreamDevice(QFile &device, const QString &source)
+{
+#ifdef Q_OS_UNIX
+    if (source == "-")
+        return device.open(STDIN_FILENO, QIODevice::ReadOnly, QFileDevice::DontCloseHandle);
+
+    const int fd = ::open(QFile::encodeName(source).constData(), O_RDONLY | O_NONBLOCK);
+    if (fd < 0)
+        return false;
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+    if (!device.open(fd, QIODevice::ReadOnly, QFileDevice::AutoCloseHandle))
+    {
+        ::close(fd);
+        return false;
+    }
+    return true;
+#else
+    if (source == "-")
+        return device.open(stdin, QIODevice::ReadOnly);
+    device.setFileName(source);
+    return device.open(QIODevice::ReadOnly); // Blocks until a writer opens a FIFO
+#endif
+}
+
+// Waits until the stream has data or was closed; false once the stream has
+// been cancelled (generation no longer current)
+static bool waitForStreamData(QFile *device, const QAtomicInt &currentGeneration, int generation)
+{
+#ifdef Q_OS_UNIX
+    pollfd fd;
+    fd.fd = device->handle();
+    fd.events = POLLIN;
+    while (currentGeneration.loadAcquire() == generation)
+    {
+        fd.revents = 0;
+        const int ready = ::poll(&fd, 1, STREAM_CANCEL_POLL_MS);
+        if (ready > 0 || (ready < 0 && errno != EINTR))
+            return true; // Data, a hang-up or an error: the read tells which
+    }
+    return false;
+#else
+    Q_UNUSED(device);
+    return currentGeneration.loadAcquire() == generation; // The read itself waits
+#endif
+}
+
+// Line read that works on pipes, where atEnd() only means "nothing buffered
+// yet". False when the stream closed or was cancelled.
+static bool readStreamLine(QFile *device, QString *line, const QAtomicInt &currentGeneration, int generation)
+{
+    if (!device->canReadLine() && !waitForStreamData(device, currentGeneration, generation))
+        return false;
+
+    const QByteArray raw = device->readLine();
+    if (raw.isEmpty())
+        return false;
+
+    *line = QString::fromUtf8(raw).trimmed();
+    return true;
+}
+
+// Whitespace-separated tokens of a definitions line
+static QStringList splitHeaderTokens(const QString &line)
+{
+    QStringList tokens;
+    int i = 0;
+    const int size = line.size();
+    while (i < size) {
+        while (i < size && line.at(i).isSpace())
+            i++;
+        int start = i;
+        while (i < size && !line.at(i).isSpace())
+            i++;
+        if (i > start)
+            tokens.append(line.mid(start, i - start));
+    }
+    return tokens;
+}
 
 VCDParser::VCDParser(QObject *parent)
-    : QObject(parent), endTime(0)
+    : QObject(parent), currentScope(0), endTime(0), skippingHeaderBlock(false), streamSource(false),
+      streamBytes(0), windowStart(0), windowEnd(-1), dataStartOffset(-1)
 {
+    nextAsyncLoadId = 0;
+    asyncLoadGeneration = 0;
+    signalNameIndex = new SignalNameIndex();
+    clearHeaderTable();
 }
 
 VCDParser::~VCDParser()
 {
+    // Background scans post their results to this object
+    for (QFuture<void> &future : asyncLoadFutures) {
+        future.waitForFinished();
+    }
+    cancelStream();
+    streamReaders.waitForDone();
+
+    SignalCache::instance().removeAll(this);
+    delete signalNameIndex;
+}
+
+// Approximate heap footprint of one signal's value changes
+static qint64 estimateSignalBytes(const QVector<VCDValueChange> &changes)
+{
+    qint64 bytes = qint64(changes.capacity()) * sizeof(VCDValueChange);
+    for (const VCDValueChange &change : changes) {
+        if (change.value.size() > 1) {
+            bytes += 32 + change.value.size() * sizeof(QChar); // Scalar values are shared
+        }
+    }
+    return bytes;
+}
+
+void VCDParser::storeSignalData(const QString &identifier, const QVector<VCDValueChange> &changes)
+{
+    valueChanges[identifier] = changes;
+    loadedSignals.insert(identifier);
+    edgeIndexes.remove(identifier);
+
+    // Streamed data cannot be re-read, so it is never handed to the cache
+    if (!streamSource) {
+        SignalCache::instance().insert(this, identifier, estimateSignalBytes(changes));
+    }
+}
+
+void VCDParser::evictSignalData(const QString &identifier)
+{
+    valueChanges.remove(identifier);
+    loadedSignals.remove(identifier);
+    edgeIndexes.remove(identifier);
+}
+
+QString VCDParser::identifierOf(const QString &fullName) const
+{
+    SignalHandle handle = findSignal(fullName);
+    return handle != InvalidSignalHandle ? nameTable.at(signalTable.at(handle).identifier) : QString();
+}
+
+QList<QString> VCDParser::getAliases(const QString &fullName) const
+{
+    QList<QString> aliases;
+    SignalHandle handle = findSignal(fullName);
+    if (handle == InvalidSignalHandle) {
+        return aliases;
+    }
+
+    for (SignalHandle alias : identifierMap.value(signalTable.at(handle).identifier)) {
+        aliases.append(getFullName(alias));
+    }
+    return aliases;
+}
+
+void VCDParser::clearHeaderTable()
+{
+    nameTable.clear();
+    nameIndex.clear();
+    scopeTable.clear();
+    scopeChildIndex.clear();
+    signalTable.clear();
+    fullNameIndex.clear();
+    identifierMap.clear();
+    derivedSignals.clear(); // Their inputs are gone with the table
+    linkedOffsets.clear();
+    portDirectionCount = 0;
+    signalNameIndex->clear();
+
+    // Scope 0 is the unnamed root, so signals outside any $scope still have one
+    ScopeEntry root;
+    root.parent = 0;
+    root.name = intern(QString());
+    scopeTable.append(root);
+    currentScope = 0;
+    buildScopeTree();
+}
+
+// Lays out the hierarchy for views: child lists and preorder signal ranges
+void VCDParser::buildScopeTree()
+{
+    const int scopeCount = scopeTable.size();
+    VCDScopeTree tree;
+
+    // Children of every scope, in declaration order
+    QVector<int> childCount(scopeCount, 0);
+    for (int s = 1; s < scopeCount; ++s) {
+        childCount[scopeTable.at(s).parent]++;
+    }
+
+    tree.childBegin.resize(scopeCount + 1);
+    tree.childBegin[0] = 0;
+    for (int s = 0; s < scopeCount; ++s) {
+        tree.childBegin[s + 1] = tree.childBegin[s] + childCount[s];
+    }
+
+    tree.childScopes.resize(tree.childBegin[scopeCount]);
+    tree.childRow.fill(0, scopeCount);
+    QVector<int> next = tree.childBegin;
+    for (int s = 1; s < scopeCount; ++s) {
+        quint32 parent = scopeTable.at(s).parent;
+        tree.childRow[s] = next[parent] - tree.childBegin[parent];
+        tree.childScopes[next[parent]++] = s;
+    }
+
+    QVector<int> ownCount(scopeCount, 0);
+    for (const SignalEntry &entry : signalTable) {
+        ownCount[entry.scope]++;
+    }
+
+    // Preorder walk: a scope's signals come first, then each child's subtree
+    tree.signalBegin.resize(scopeCount);
+    tree.signalEnd.resize(scopeCount);
+    tree.subtreeEnd.resize(scopeCount);
+    int position = ownCount[0];
+    tree.signalBegin[0] = 0;
+    tree.signalEnd[0] = position;
+    QVector<QPair<quint32, int>> stack; // (scope, next child position)
+    stack.append(qMakePair(quint32(0), tree.childBegin[0]));
+    while (!stack.isEmpty()) {
+        QPair<quint32, int> &top = stack.last();
+        if (top.second < tree.childBegin[top.first + 1]) {
+            quint32 child = tree.childScopes[top.second++];
+            tree.signalBegin[child] = position;
+            position += ownCount[child];
+            tree.signalEnd[child] = position;
+            stack.append(qMakePair(child, tree.childBegin[child]));
+        } else {
+            tree.subtreeEnd[top.first] = position;
+            stack.removeLast();
+        }
+    }
+
+    tree.signalOrder.resize(signalTable.size());
+    next = tree.signalBegin;
+    for (int h = 0; h < signalTable.size(); ++h) {
+        tree.signalOrder[next[signalTable.at(h).scope]++] = h;
+    }
+
+    scopeTree = tree;
+}
+
+quint32 VCDParser::intern(const QString &text)
+{
+    auto it = nameIndex.constFind(text);
+    if (it != nameIndex.constEnd()) {
+        return it.value();
+    }
+
+    quint32 index = nameTable.size();
+    nameTable.append(text);
+    nameIndex.insert(text, index);
+    return index;
+}
+
+// Dotted path of a scope, built by walking up to the root
+QString VCDParser::scopePath(quint32 scope) const
+{
+    QVector<quint32> chain;
+    while (scope != 0) {
+        chain.append(scopeTable.at(scope).name);
+        scope = scopeTable.at(scope).parent;
+    }
+
+    QString path;
+    for (int i = chain.size() - 1; i >= 0; --i) {
+        if (!path.isEmpty()) {
+            path += '.';
+        }
+        path += nameTable.at(chain.at(i));
+    }
+    return path;
+}
+
+QString VCDParser::getFullName(SignalHandle handle) const
+{
+    if (handle >= quint32(signalTable.size())) {
+        return QString();
+    }
+
+    const SignalEntry &entry = signalTable.at(handle);
+    QString path = scopePath(entry.scope);
+    if (path.isEmpty()) {
+        return nameTable.at(entry.name);
+    }
+    return path + "." + nameTable.at(entry.name);
+}
+
+// Compares a dotted name against the table from the leaf upwards, without building the string
+bool VCDParser::matchesFullName(SignalHandle handle, const QString &fullName) const
+{
+    const SignalEntry &entry = signalTable.at(handle);
+    int end = fullName.size();
+
+    const QString &leaf = nameTable.at(entry.name);
+    if (end < leaf.size() || QStringView(fullName).mid(end - leaf.size(), leaf.size()) != QStringView(leaf)) {
+        return false;
+    }
+    end -= leaf.size();
+
+    for (quint32 scope = entry.scope; scope != 0; scope = scopeTable.at(scope).parent) {
+        const QString &name = nameTable.at(scopeTable.at(scope).name);
+        if (end < name.size() + 1 || fullName.at(end - 1) != '.' ||
+            QStringView(fullName).mid(end - 1 - name.size(), name.size()) != QStringView(name)) {
+            return false;
+        }
+        end -= name.size() + 1;
+    }
+
+    return end == 0;
+}
+
+SignalHandle VCDParser::findSignal(const QString &fullName) const
+{
+    // Newest entry first, so a repeated full name resolves to its last declaration
+    const uint hash = qHash(fullName);
+    auto it = fullNameIndex.constFind(hash);
+    while (it != fullNameIndex.constEnd() && it.key() == hash) {
+        if (matchesFullName(it.value(), fullName)) {
+            return it.value();
+        }
+        ++it;
+    }
+    return InvalidSignalHandle;
+}
+
+VCDSignal VCDParser::getSignal(SignalHandle handle) const
+{
+    VCDSignal signal;
+    signal.width = 0;
+    if (handle >= quint32(signalTable.size())) {
+        return signal;
+    }
+
+    const SignalEntry &entry = signalTable.at(handle);
+    signal.identifier = nameTable.at(entry.identifier);
+    signal.name = nameTable.at(entry.name);
+    signal.scope = scopePath(entry.scope);
+    signal.width = entry.width;
+    signal.type = nameTable.at(entry.type);
+    signal.fullName = signal.scope.isEmpty() ? signal.name : signal.scope + "." + signal.name;
+    if (entry.direction != NoDirection) {
+        signal.direction = nameTable.at(entry.direction);
+    }
+    return signal;
+}
+
+QString VCDParser::getSignalDirection(SignalHandle handle) const
+{
+    quint32 direction = signalTable.at(handle).direction;
+    return direction == NoDirection ? QString() : nameTable.at(direction);
+}
+
+void VCDParser::setSignalDirection(SignalHandle handle, const QString &direction)
+{
+    SignalEntry &entry = signalTable[handle];
+    if (entry.direction == NoDirection) {
+        portDirectionCount++;
+    }
+    entry.direction = intern(direction);
+}
+
+void VCDParser::clearPortDirections()
+{
+    for (SignalEntry &entry : signalTable) {
+        entry.direction = NoDirection;
+    }
+    portDirectionCount = 0;
 }
 
+QVector<VCDSignal> VCDParser::getSignals() const
+{
+    QVector<VCDSignal> result;
+    result.reserve(signalTable.size());
+
+    // Scope paths are shared between the signals of one scope
+    QHash<quint32, QString> paths;
+    for (int i = 0; i < signalTable.size(); ++i) {
+        const SignalEntry &entry = signalTable.at(i);
+        auto path = paths.find(entry.scope);
+        if (path == paths.end()) {
+            path = paths.insert(entry.scope, scopePath(entry.scope));
+        }
 
+        VCDSignal signal;
+        signal.identifier = nameTable.at(entry.identifier);
+        signal.name = nameTable.at(entry.name);
+        signal.scope = path.value();
+        signal.width = entry.width;
+        signal.type = nameTable.at(entry.type);
+        signal.fullName = signal.scope.isEmpty() ? signal.name : signal.scope + "." + signal.name;
+        result.append(signal);
+    }
+    return result;
+}
 
-QString VCDParser::generateFullName(const QString &scope, const QString &name)
+void VCDParser::clearSignalData()
 {
-    if (scope.isEmpty()) {
-        return name;
+    SignalCache::instance().removeAll(this);
+    streamBytes = 0;
+    valueChanges.clear();
+    loadedSignals.clear();
+    edgeIndexes.clear();
+    valueHistograms.clear();
+    for (DerivedSignal &derived : derivedSignals) {
+        derived.cacheValid = false;
+        derived.cache.clear();
     }
-    return scope + "." + name;
+
+    // Loads still running read the old file or range
+    asyncLoadGeneration++;
+    asyncLoads.clear();
+    pendingIdentifiers.clear();
+    failedIdentifiers.clear();
 }
 
+
+
 bool VCDParser::parseFile(const QString &filename)
 {
     // For now, use header-only parsing for performance
@@ -36,15 +531,17 @@ bool VCDParser::parseHeaderOnly(const QString &filename)
     }
 
     vcdFilename = filename;
+    streamSource = false;
     QTextStream stream(&file);
     
-    vcdSignals.clear();
-    identifierMap.clear();
-    fullNameMap.clear();  // ADD THIS
-    currentScope.clear();
-    valueChanges.clear();
-    loadedSignals.clear();
+    clearHeaderTable();
+    clearSignalData();
     endTime = 0;
+    windowStart = 0;
+    windowEnd = -1;
+    dataStartOffset = -1;
+    timeCheckpoints.clear();
+    checkpointValues.clear();
 
     if (!parseHeader(stream)) {
         file.close();
@@ -52,66 +549,25 @@ bool VCDParser::parseHeaderOnly(const QString &filename)
     }
 
     file.close();
+    buildScopeTree();
+    signalNameIndex->build(*this);
 
     qDebug() << "VCD header parsing completed";
-    qDebug() << "Signals found:" << vcdSignals.size();
+    qDebug() << "Signals found:" << signalTable.size();
     qDebug() << "Unique identifiers:" << identifierMap.size();
-    qDebug() << "Unique full names:" << fullNameMap.size();
+    qDebug() << "Scopes:" << scopeTable.size() - 1 << "Interned names:" << nameTable.size();
 
     return true;
 }
 
 bool VCDParser::parseHeader(QTextStream &stream)
 {
-    QRegularExpression scopeRegex("^\\$scope\\s+(\\w+)\\s+(\\S+)\\s*\\$end$");
-    QRegularExpression varRegex("^\\$var\\s+(\\w+)\\s+(\\d+)\\s+(\\S+)\\s+(.+)\\s*\\$end$");
-    QRegularExpression timescaleRegex("^\\$timescale\\s+(\\S+)\\s*\\$end$");
+    skippingHeaderBlock = false;
 
     while (!stream.atEnd()) {
         QString line = stream.readLine().trimmed();
 
-        if (line.startsWith("$date")) {
-            // Skip date section
-            while (!stream.atEnd() && !line.contains("$end")) {
-                line = stream.readLine().trimmed();
-            }
-        }
-        else if (line.startsWith("$version")) {
-            // Skip version section
-            while (!stream.atEnd() && !line.contains("$end")) {
-                line = stream.readLine().trimmed();
-            }
-        }
-        else if (line.startsWith("$comment")) {
-            // Skip comment section
-            while (!stream.atEnd() && !line.contains("$end")) {
-                line = stream.readLine().trimmed();
-            }
-        }
-        else if (line.startsWith("$timescale")) {
-            parseTimescale(line);
-        }
-        else if (line.startsWith("$scope")) {
-            parseScopeLine(line);
-        }
-        else if (line.startsWith("$var")) {
-            parseVarLine(line);
-        }
-        else if (line.startsWith("$upscope")) {
-            // Move up one scope level
-            int lastDot = currentScope.lastIndexOf('.');
-            if (lastDot != -1) {
-                currentScope = currentScope.left(lastDot);
-            } else {
-                currentScope.clear();
-            }
-        }
-        else if (line.startsWith("$enddefinitions")) {
-            // End of header
-            break;
-        }
-        else if (line.startsWith("#")) {
-            // We reached the value change section, stop header parsing
+        if (!processHeaderLine(line)) {
             break;
         }
     }
@@ -119,217 +575,1456 @@ bool VCDParser::parseHeader(QTextStream &stream)
     return true;
 }
 
-
-// Update the value change functions to use fullName
-bool VCDParser::loadSignalsData(const QList<QString> &fullNames)
+// Handles one definitions line; returns false once the value change section starts
+bool VCDParser::processHeaderLine(const QString &line)
 {
-    if (fullNames.isEmpty()) {
+    if (skippingHeaderBlock) {
+        // Inside a $date/$version/$comment block
+        if (line.contains("$end")) {
+            skippingHeaderBlock = false;
+        }
         return true;
     }
 
-    QFile file(vcdFilename);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        errorString = "Cannot open file for signal loading: " + vcdFilename;
+    if (line.startsWith("$date") || line.startsWith("$version") || line.startsWith("$comment")) {
+        // Skip the section, which may span several lines
+        skippingHeaderBlock = !line.contains("$end");
+    }
+    else if (line.startsWith("$timescale")) {
+        parseTimescale(line);
+    }
+    else if (line.startsWith("$scope")) {
+        parseScopeLine(line);
+    }
+    else if (line.startsWith("$var")) {
+        parseVarLine(line);
+    }
+    else if (line.startsWith("$upscope")) {
+        // Move up one scope level
+        currentScope = scopeTable.at(currentScope).parent;
+    }
+    else if (line.startsWith("$enddefinitions")) {
+        // End of header
         return false;
     }
-
-    QTextStream stream(&file);
-    
-    // Convert to set for fast lookup - but we need to map fullNames back to identifiers
-    QSet<QString> signalsToLoad;
-    for (const QString &fullName : fullNames) {
-        if (fullNameMap.contains(fullName) && !loadedSignals.contains(fullName)) {
-            QString identifier = fullNameMap[fullName].identifier;
-            signalsToLoad.insert(identifier);
-            // Initialize empty value changes using fullName as key
-            valueChanges[fullName] = QVector<VCDValueChange>();
-        }
+    else if (line.startsWith("#")) {
+        // We reached the value change section, stop header parsing
+        return false;
     }
 
-    if (signalsToLoad.isEmpty()) {
-        file.close();
-        return true; // All signals already loaded
-    }
+    return true;
+}
 
-    qDebug() << "Loading data for" << signalsToLoad.size() << "signals";
+bool VCDParser::parseStream(const QString &source)
+{
+    // Runs on a worker thread and never touches this parser's tables: the
+    // header is read into a parser of its own and handed over on this
+    // object's thread, then value changes are collected in batches and
+    // appended there too. Anything left over from a cancelled stream is
+    // dropped by its generation.
+    const int generation = streamGeneration.fetchAndAddOrdered(1) + 1;
 
-    if (!parseValueChangesForSignals(stream, signalsToLoad)) {
-        file.close();
+    QFile device;
+    if (!openStreamDevice(device, source)) {
+        reportStreamError("Cannot open stream: " + source, generation);
         return false;
     }
 
-    file.close();
-
-    // Mark signals as loaded using fullName
-    for (const QString &fullName : fullNames) {
-        if (fullNameMap.contains(fullName)) {
-            loadedSignals.insert(fullName);
+    // Owned by our thread from the start, so deleteLater() always has a loop to run on
+    QSharedPointer<VCDParser> header(new VCDParser(), &QObject::deleteLater);
+    header->moveToThread(thread());
+    QString line;
+    bool headerComplete = false;
+    while (readStreamLine(&device, &line, streamGeneration, generation)) {
+        if (!header->processHeaderLine(line)) {
+            headerComplete = true;
+            break;
         }
     }
 
-    qDebug() << "Successfully loaded data for" << signalsToLoad.size() << "signals";
-    return true;
-}
-
-
-bool VCDParser::parseValueChangesForSignals(QTextStream &stream, const QSet<QString> &signalsToLoad)
-{
-    QRegularExpression timestampRegex("^#(\\d+)$");
-    QRegularExpression valueChangeRegex("^([01xXzZrb])(\\S+)$");
-    QRegularExpression vectorValueRegex("^[bB]([01xXzZ]+)\\s+(\\S+)$");
+    if (streamGeneration.loadAcquire() != generation) {
+        return true; // Cancelled while waiting for definitions
+    }
+    if (!headerComplete) {
+        reportStreamError("Stream closed before $enddefinitions: " + source, generation);
+        return false;
+    }
 
-    int currentTime = 0;
-    int changesFound = 0;
+    header->buildScopeTree();
+    header->signalNameIndex->build(*header);
 
-    // Create a reverse mapping from identifier to all possible fullNames
-    QMap<QString, QList<QString>> identifierToFullNames;
-    for (const auto &signal : vcdSignals) {
-        identifierToFullNames[signal.identifier].append(signal.fullName);
+    // Everything is loaded as it arrives, nothing is ever re-read
+    QSet<QString> knownIdentifiers;
+    for (auto it = header->identifierMap.constBegin(); it != header->identifierMap.constEnd(); ++it) {
+        knownIdentifiers.insert(header->nameTable.at(it.key()));
     }
 
-    while (!stream.atEnd()) {
-        QString line = stream.readLine().trimmed();
+    qDebug() << "VCD stream header parsed, signals:" << header->signalTable.size();
+    QMetaObject::invokeMethod(this, [this, header, knownIdentifiers, generation]() {
+        adoptStreamHeader(header.data(), knownIdentifiers, generation);
+    }, Qt::QueuedConnection);
 
-        if (line.isEmpty()) continue;
+    QMap<QString, QVector<VCDValueChange>> batch;
+    int currentTime = 0;
+    int batchLines = 0;
+    qint64 totalLines = 0;
+    QElapsedTimer flushTimer;
+    flushTimer.start();
+    QString value;
+    QString identifier;
 
-        // Check for timestamp
-        QRegularExpressionMatch timestampMatch = timestampRegex.match(line);
-        if (timestampMatch.hasMatch()) {
-            currentTime = timestampMatch.captured(1).toInt();
-            endTime = qMax(endTime, currentTime);
-            continue;
-        }
+    auto flushBatch = [&]() {
+        QMetaObject::invokeMethod(this, [this, batch, currentTime, generation]() {
+            appendStreamBatch(batch, currentTime, generation);
+        }, Qt::QueuedConnection);
+        batch.clear();
+        batchLines = 0;
+        flushTimer.restart();
+    };
 
-        // Handle scalar value changes (0, 1, x, z)
-        QRegularExpressionMatch valueMatch = valueChangeRegex.match(line);
-        if (valueMatch.hasMatch()) {
-            QString value = valueMatch.captured(1).toUpper();
-            QString identifier = valueMatch.captured(2);
-
-            if (signalsToLoad.contains(identifier)) {
-                // Apply this value change to ALL signals with this identifier
-                if (identifierToFullNames.contains(identifier)) {
-                    for (const QString &fullName : identifierToFullNames[identifier]) {
-                        VCDValueChange change;
-                        change.timestamp = currentTime;
-                        change.value = value;
-                        valueChanges[fullName].append(change);
-                        changesFound++;
-                    }
-                }
-            }
+    // The line that ended the header may already be the first timestamp
+    do {
+        if (line.isEmpty()) {
             continue;
         }
 
-        // Handle vector value changes (binary)
-        QRegularExpressionMatch vectorMatch = vectorValueRegex.match(line);
-        if (vectorMatch.hasMatch()) {
-            QString value = vectorMatch.captured(1);
-            QString identifier = vectorMatch.captured(2);
-
-            if (signalsToLoad.contains(identifier)) {
-                // Apply this value change to ALL signals with this identifier
-                if (identifierToFullNames.contains(identifier)) {
-                    for (const QString &fullName : identifierToFullNames[identifier]) {
-                        VCDValueChange change;
-                        change.timestamp = currentTime;
-                        change.value = value;
-                        valueChanges[fullName].append(change);
-                        changesFound++;
-                    }
-                }
+        int timestamp = 0;
+        if (parseTimestampLine(line, &timestamp)) {
+            currentTime = timestamp;
+        }
+        else if (parseValueChangeLine(line, &value, &identifier)) {
+            if (knownIdentifiers.contains(identifier)) {
+                VCDValueChange change;
+                change.timestamp = currentTime;
+                change.value = value;
+                batch[identifier].append(change);
             }
-            continue;
         }
 
-        // Handle real value changes
-        if (line.startsWith("r")) {
-            QStringList parts = line.split(" ", Qt::SkipEmptyParts);
-            if (parts.size() >= 2) {
-                QString value = parts[0].mid(1); // Remove 'r' prefix
-                QString identifier = parts[1];
-                
-                if (signalsToLoad.contains(identifier)) {
-                    // Apply this value change to ALL signals with this identifier
-                    if (identifierToFullNames.contains(identifier)) {
-                        for (const QString &fullName : identifierToFullNames[identifier]) {
-                            VCDValueChange change;
-                            change.timestamp = currentTime;
-                            change.value = value;
-                            valueChanges[fullName].append(change);
-                            changesFound++;
-                        }
-                    }
-                }
+        totalLines++;
+        if (++batchLines >= STREAM_BATCH_LINES ||
+            ((batchLines & 1023) == 0 && flushTimer.elapsed() >= STREAM_FLUSH_INTERVAL_MS)) {
+            if (streamGeneration.loadAcquire() != generation) {
+                qDebug() << "VCD stream cancelled after" << totalLines << "lines";
+                return true;
             }
+            flushBatch();
         }
+    } while (readStreamLine(&device, &line, streamGeneration, generation));
+
+    if (streamGeneration.loadAcquire() != generation) {
+        qDebug() << "VCD stream cancelled after" << totalLines << "lines";
+        return true;
     }
+    flushBatch();
 
-    qDebug() << "Found" << changesFound << "value changes for requested signals";
+    qDebug() << "VCD stream closed after" << totalLines << "lines, end time" << currentTime;
     return true;
 }
-QVector<VCDValueChange> VCDParser::getValueChangesForSignal(const QString &fullName)
+
+// Takes over the definitions read by parseStream() on the worker thread
+void VCDParser::adoptStreamHeader(VCDParser *header, const QSet<QString> &knownIdentifiers, int generation)
 {
-    // If signal data is not loaded yet, load it now
-    if (!loadedSignals.contains(fullName)) {
-        QList<QString> signalsToLoad = {fullName};
-        loadSignalsData(signalsToLoad);
+    if (generation != streamGeneration.loadAcquire()) {
+        return; // Another file or stream was opened meanwhile
     }
-    
-    return valueChanges.value(fullName);
+
+    clearHeaderTable();
+    clearSignalData();
+    nameTable.swap(header->nameTable);
+    nameIndex.swap(header->nameIndex);
+    scopeTable.swap(header->scopeTable);
+    scopeChildIndex.swap(header->scopeChildIndex);
+    signalTable.swap(header->signalTable);
+    fullNameIndex.swap(header->fullNameIndex);
+    identifierMap.swap(header->identifierMap);
+    scopeTree = header->scopeTree;
+    qSwap(signalNameIndex, header->signalNameIndex);
+    currentScope = header->currentScope;
+    timescale = header->timescale;
+
+    vcdFilename.clear();
+    streamSource = true;
+    loadedSignals = knownIdentifiers;
+    endTime = 0;
+    windowStart = 0;
+    windowEnd = -1;
+    dataStartOffset = -1;
+    timeCheckpoints.clear();
+    checkpointValues.clear();
+
+    emit streamHeaderReady();
 }
 
-void VCDParser::parseTimescale(const QString &line)
+void VCDParser::reportStreamError(const QString &message, int generation)
 {
-    QRegularExpression regex("^\\$timescale\\s+(\\S+)\\s*\\$end$");
-    QRegularExpressionMatch match = regex.match(line);
-    if (match.hasMatch()) {
-        timescale = match.captured(1);
-        qDebug() << "Timescale:" << timescale;
-    }
+    QMetaObject::invokeMethod(this, [this, message, generation]() {
+        if (generation == streamGeneration.loadAcquire()) {
+            errorString = message;
+        }
+    }, Qt::QueuedConnection);
 }
 
-void VCDParser::parseScopeLine(const QString &line)
+QFuture<bool> VCDParser::readStream(const QString &source)
 {
-    QRegularExpression regex("^\\$scope\\s+(\\w+)\\s+(\\S+)\\s*\\$end$");
-    QRegularExpressionMatch match = regex.match(line);
-    if (match.hasMatch()) {
-        QString scopeType = match.captured(1);
-        QString scopeName = match.captured(2);
-        
-        if (!currentScope.isEmpty()) {
-            currentScope += "." + scopeName;
-        } else {
-            currentScope = scopeName;
-        }
-    }
+    return QtConcurrent::run(&streamReaders, [this, source]() { return parseStream(source); });
 }
 
-void VCDParser::parseVarLine(const QString &line)
+void VCDParser::cancelStream()
 {
-    QRegularExpression regex("^\\$var\\s+(\\w+)\\s+(\\d+)\\s+(\\S+)\\s+(.+)\\s*\\$end$");
-    QRegularExpressionMatch match = regex.match(line);
+    // A reader waiting for data returns within STREAM_CANCEL_POLL_MS; batches
+    // still queued from the old stream are dropped in appendStreamBatch
+    streamGeneration.fetchAndAddOrdered(1);
+}
+
+void VCDParser::appendStreamBatch(const QMap<QString, QVector<VCDValueChange>> &batch, int batchEndTime, int generation)
+{
+    if (generation != streamGeneration.loadAcquire()) {
+        return; // Left over from a cancelled stream
+    }
+
+    for (auto it = batch.constBegin(); it != batch.constEnd(); ++it) {
+        valueChanges[it.key()] += it.value();
+        edgeIndexes.remove(it.key());
+        valueHistograms.remove(it.key());
+        streamBytes += estimateSignalBytes(it.value());
+    }
+    for (DerivedSignal &derived : derivedSignals) {
+        derived.cacheValid = false;
+    }
+    endTime = qMax(endTime, batchEndTime);
+
+    // Streamed data cannot be re-read: it stays, and file-backed signals
+    // (of any parser) are evicted to make room. Past the whole budget, the
+    // oldest part of the stream has to go.
+    SignalCache &cache = SignalCache::instance();
+    cache.setPinnedBytes(this, streamBytes);
+    cache.enforceLimit();
+    if (streamBytes > cache.limitBytes()) {
+        trimStreamHistory(cache.limitBytes() * STREAM_TRIM_PERCENT / 100);
+    }
+
+    emit streamDataAppended(endTime);
+}
+
+// Drops the changes before a cut time chosen so roughly targetBytes remain,
+// assuming changes are spread evenly over time. Each signal keeps the value
+// it held at the cut as a change there.
+void VCDParser::trimStreamHistory(qint64 targetBytes)
+{
+    int firstTime = endTime;
+    for (auto it = valueChanges.constBegin(); it != valueChanges.constEnd(); ++it) {
+        if (!it.value().isEmpty()) {
+            firstTime = qMin(firstTime, it.value().first().timestamp);
+        }
+    }
+    if (streamBytes <= 0 || firstTime >= endTime) {
+        return;
+    }
+
+    const double keep = double(targetBytes) / double(streamBytes);
+    const int cutTime = endTime - int(keep * (qint64(endTime) - firstTime));
+
+    streamBytes = 0;
+    for (auto it = valueChanges.begin(); it != valueChanges.end(); ++it) {
+        QVector<VCDValueChange> &changes = it.value();
+        const int first = EdgeIndex::upperBound(changes, cutTime) - 1; // Change in effect at the cut
+        if (first > 0) {
+            QVector<VCDValueChange> kept = changes.mid(first);
+            kept[0].timestamp = cutTime;
+            changes.swap(kept);
+            edgeIndexes.remove(it.key());
+            valueHistograms.remove(it.key());
+        }
+        streamBytes += estimateSignalBytes(changes);
+    }
+    for (DerivedSignal &derived : derivedSignals) {
+        derived.cacheValid = false;
+    }
+    SignalCache::instance().setPinnedBytes(this, streamBytes);
+
+    qWarning() << "Stream is over the memory budget, dropped changes before time" << cutTime << ", keeping"
+               << streamBytes / (1024 * 1024) << "MB";
+    emit streamHistoryTrimmed(cutTime);
+}
+
+
+// Update the value change functions to use fullName
+bool VCDParser::loadSignalsData(const QList<QString> &fullNames)
+{
+    if (fullNames.isEmpty()) {
+        return true;
+    }
+
+    // NEW: A derived signal loads the signals it is computed from, a linked
+    // row the signal in its own dump
+    if (!derivedSignals.isEmpty()) {
+        QHash<VCDParser *, QList<QString>> linked;
+        const QList<QString> expanded = expandDerivedSignals(fullNames, &linked);
+        if (expanded != fullNames) {
+            bool ok = true;
+            for (auto it = linked.constBegin(); it != linked.constEnd(); ++it) {
+                ok = it.key()->loadSignalsData(it.value()) && ok;
+            }
+            return loadSignalsData(expanded) && ok;
+        }
+    }
+
+    if (streamSource) {
+        return true; // Streamed dumps hold every signal already
+    }
+
+    if (hasTimeWindow()) {
+        QList<QString> missing;
+        for (const QString &fullName : fullNames) {
+            if (!isSignalLoaded(fullName)) {
+                missing.append(fullName);
+            }
+        }
+        return loadSignalsDataInWindow(missing, windowStart, windowEnd);
+    }
+
+    QFile file(vcdFilename);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        errorString = "Cannot open file for signal loading: " + vcdFilename;
+        return false;
+    }
+
+    QTextStream stream(&file);
+    
+    // Convert to set for fast lookup - aliases collapse onto one identifier
+    QSet<QString> signalsToLoad;
+    for (const QString &fullName : fullNames) {
+        QString identifier = identifierOf(fullName);
+        if (!identifier.isEmpty() && !loadedSignals.contains(identifier)) {
+            signalsToLoad.insert(identifier);
+            // Initialize empty value changes, stored once per identifier
+            valueChanges[identifier] = QVector<VCDValueChange>();
+        }
+    }
+
+    if (signalsToLoad.isEmpty()) {
+        file.close();
+        return true; // All signals already loaded
+    }
+
+    qDebug() << "Loading data for" << signalsToLoad.size() << "signals";
+
+    if (!parseValueChangesForSignals(stream, signalsToLoad)) {
+        file.close();
+        return false;
+    }
+
+    file.close();
+
+    // Mark identifiers as loaded and account for them in the cache
+    for (const QString &identifier : signalsToLoad) {
+        storeSignalData(identifier, valueChanges.value(identifier));
+    }
+    SignalCache::instance().enforceLimit();
+
+    qDebug() << "Successfully loaded data for" << signalsToLoad.size() << "signals";
+    return true;
+}
+
+
+void VCDParser::loadSignalsDataAsync(const QList<QString> &fullNames)
+{
+    if (!derivedSignals.isEmpty()) {
+        QHash<VCDParser *, QList<QString>> linked;
+        const QList<QString> expanded = expandDerivedSignals(fullNames, &linked);
+        if (expanded != fullNames) {
+            for (auto it = linked.constBegin(); it != linked.constEnd(); ++it) {
+                it.key()->loadSignalsDataAsync(it.value()); // Relayed as our signalsDataLoaded()
+            }
+            loadSignalsDataAsync(expanded);
+            return;
+        }
+    }
+
+    QSet<QString> wanted;
+    for (const QString &fullName : fullNames) {
+        QString identifier = identifierOf(fullName);
+        if (!identifier.isEmpty() && !loadedSignals.contains(identifier) && !pendingIdentifiers.contains(identifier) &&
+            !failedIdentifiers.contains(identifier)) {
+            wanted.insert(identifier);
+        }
+    }
+    if (wanted.isEmpty()) {
+        return;
+    }
+
+    // Streams hold everything already, and window loads seek from the
+    // nearest checkpoint instead of scanning; both run on this thread, but
+    // from the event loop, never inside the caller (which may be painting)
+    if (streamSource || hasTimeWindow()) {
+        pendingIdentifiers.unite(wanted);
+        const int generation = asyncLoadGeneration;
+        QMetaObject::invokeMethod(this, [this, fullNames, wanted, generation]() {
+            if (generation != asyncLoadGeneration) {
+                return; // Data was cleared meanwhile
+            }
+            pendingIdentifiers.subtract(wanted);
+            if (!loadSignalsData(fullNames)) {
+                // Not asked for again until the window or file changes, or
+                // every repaint would retry the same failing read
+                failedIdentifiers.unite(wanted);
+                qDebug() << "Window load failed:" << errorString;
+            }
+            emit signalsDataLoaded(); // Also takes the loading rows down after a failure
+        }, Qt::QueuedConnection);
+        return;
+    }
+
+    QFile file(vcdFilename);
+    if (!file.open(QIODevice::ReadOnly) || !locateDataSection(file)) {
+        errorString = "Cannot open file for signal loading: " + vcdFilename;
+        failedIdentifiers.unite(wanted);
+        return;
+    }
+    const qint64 dataStart = dataStartOffset;
+    const qint64 fileSize = file.size();
+    file.close();
+
+    const int threads = qMax(1, QThreadPool::globalInstance()->maxThreadCount());
+    const int chunks = int(qBound<qint64>(1, (fileSize - dataStart) / MIN_LOAD_CHUNK_BYTES, threads));
+    const qint64 chunkBytes = (fileSize - dataStart) / chunks + 1;
+
+    const int loadId = nextAsyncLoadId++;
+    AsyncLoad &load = asyncLoads[loadId];
+    load.generation = asyncLoadGeneration;
+    load.chunksLeft = chunks;
+    load.chunks.resize(chunks);
+    load.identifiers = wanted;
+    pendingIdentifiers.unite(wanted);
+
+    qDebug() << "Loading" << wanted.size() << "signals in the background," << chunks << "pieces";
+
+    // Scans of earlier loads that are done need no waiting for
+    for (int i = asyncLoadFutures.size() - 1; i >= 0; i--) {
+        if (asyncLoadFutures[i].isFinished()) {
+            asyncLoadFutures.removeAt(i);
+        }
+    }
+
+    const QString filename = vcdFilename;
+    for (int c = 0; c < chunks; c++) {
+        const qint64 from = dataStart + c * chunkBytes;
+        const qint64 to = qMin(fileSize, from + chunkBytes);
+        asyncLoadFutures.append(QtConcurrent::run([this, filename, from, to, dataStart, wanted, loadId, c]() {
+            ChunkScan scan = scanDataChunk(filename, from, to, dataStart, wanted);
+            QMetaObject::invokeMethod(this, [this, loadId, c, scan]() {
+                finishDataChunk(loadId, c, scan);
+            }, Qt::QueuedConnection);
+        }));
+    }
+}
+
+// Runs on the thread pool, so it touches nothing but its arguments. A piece
+// starts at the first "#time" line at or after 'from' and runs until the
+// first "#time" line at or after 'to'; neighbouring pieces meet exactly.
+VCDParser::ChunkScan VCDParser::scanDataChunk(const QString &filename, qint64 from, qint64 to, qint64 dataStart,
+                                              const QSet<QString> &wanted)
+{
+    ChunkScan scan;
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return scan;
+    }
+
+    int currentTime = 0;
+    if (from > dataStart) {
+        // Move to the first line starting at or after 'from', then to a timestamp
+        file.seek(from - 1);
+        file.readLine();
+        for (;;) {
+            qint64 lineOffset = file.pos();
+            QByteArray raw = file.readLine();
+            if (raw.isEmpty()) {
+                scan.ok = true;
+                return scan; // No timestamp left for this piece
+            }
+            if (raw.startsWith('#')) {
+                file.seek(lineOffset);
+                break;
+            }
+        }
+        if (file.pos() >= to) {
+            scan.ok = true;
+            return scan; // The previous piece covers this range
+        }
+    } else {
+        file.seek(dataStart);
+    }
+
+    QString value;
+    QString identifier;
+    while (!file.atEnd()) {
+        const qint64 lineOffset = file.pos();
+        const QByteArray raw = file.readLine();
+        if (raw.startsWith('#') && lineOffset >= to) {
+            break; // The next piece starts here
+        }
+
+        const QString line = QString::fromLatin1(raw).trimmed();
+        int timestamp = 0;
+        if (parseTimestampLine(line, &timestamp)) {
+            currentTime = timestamp;
+            scan.lastTime = qMax(scan.lastTime, currentTime);
+            continue;
+        }
+
+        if (parseValueChangeLine(line, &value, &identifier) && wanted.contains(identifier)) {
+            VCDValueChange change;
+            change.timestamp = currentTime;
+            change.value = value;
+            scan.changes[identifier].append(change);
+        }
+    }
+
+    scan.ok = true;
+    return scan;
+}
+
+void VCDParser::finishDataChunk(int loadId, int chunk, const ChunkScan &scan)
+{
+    auto it = asyncLoads.find(loadId);
+    if (it == asyncLoads.end() || it->generation != asyncLoadGeneration) {
+        return; // Data was cleared meanwhile
+    }
+
+    AsyncLoad &load = it.value();
+    load.chunks[chunk] = scan;
+    if (--load.chunksLeft > 0) {
+        return;
+    }
+
+    // Pieces are in file order, so appending keeps every signal sorted by time
+    bool ok = true;
+    for (const ChunkScan &piece : load.chunks) {
+        ok = ok && piece.ok;
+        endTime = qMax(endTime, piece.lastTime);
+    }
+
+    for (const QString &identifier : load.identifiers) {
+        pendingIdentifiers.remove(identifier);
+        if (!ok) {
+            continue;
+        }
+
+        QVector<VCDValueChange> changes;
+        for (const ChunkScan &piece : load.chunks) {
+            changes += piece.changes.value(identifier);
+        }
+        storeSignalData(identifier, changes);
+    }
+    SignalCache::instance().enforceLimit();
+
+    if (!ok) {
+        // Not asked for again until the file is reloaded, or every repaint would retry
+        failedIdentifiers.unite(load.identifiers);
+        errorString = "Cannot read file for signal loading: " + vcdFilename;
+        qDebug() << errorString;
+    } else {
+        qDebug() << "Background load stored" << load.identifiers.size() << "signals";
+    }
+
+    asyncLoads.erase(it);
+    emit signalsDataLoaded();
+}
+
+bool VCDParser::parseValueChangesForSignals(QTextStream &stream, const QSet<QString> &signalsToLoad)
+{
+    int currentTime = 0;
+    int changesFound = 0;
+
+    QString value;
+    QString identifier;
+
+    while (!stream.atEnd()) {
+        QString line = stream.readLine().trimmed();
+
+        if (line.isEmpty()) continue;
+
+        // Check for timestamp
+        int timestamp = 0;
+        if (parseTimestampLine(line, &timestamp)) {
+            currentTime = timestamp;
+            endTime = qMax(endTime, currentTime);
+            continue;
+        }
+
+        // Scalar, vector and real value changes
+        if (!parseValueChangeLine(line, &value, &identifier)) {
+            continue;
+        }
+
+        if (signalsToLoad.contains(identifier)) {
+            // Stored once; every alias of this identifier reads the same vector
+            VCDValueChange change;
+            change.timestamp = currentTime;
+            change.value = value;
+            valueChanges[identifier].append(change);
+            changesFound++;
+        }
+    }
+
+    qDebug() << "Found" << changesFound << "value changes for requested signals";
+    return true;
+}
+void VCDParser::setTimeWindow(int startTime, int endTime)
+{
+    windowStart = qMax(0, startTime);
+    windowEnd = qMax(windowStart, endTime);
+
+    // An open end ("until the end of the dump") becomes the last timestamp,
+    // so views can fit the window
+    QFile file(vcdFilename);
+    int lastTime = 0;
+    if (file.open(QIODevice::ReadOnly) && locateDataSection(file) && readLastTimestamp(file, &lastTime) &&
+        lastTime < windowEnd) {
+        windowEnd = qMax(windowStart, lastTime);
+    }
+
+    // Anything loaded so far covers a different range
+    clearSignalData();
+    this->endTime = 0;
+
+    qDebug() << "Time window set to" << windowStart << "-" << windowEnd;
+}
+
+void VCDParser::clearTimeWindow()
+{
+    if (!hasTimeWindow()) {
+        return;
+    }
+
+    windowStart = 0;
+    windowEnd = -1;
+    clearSignalData();
+    endTime = 0;
+}
+
+bool VCDParser::loadSignalsDataInWindow(const QList<QString> &fullNames, int startTime, int endTimeLimit)
+{
+    if (fullNames.isEmpty() || streamSource) {
+        return true;
+    }
+
+    if (!derivedSignals.isEmpty()) {
+        QHash<VCDParser *, QList<QString>> linked;
+        const QList<QString> expanded = expandDerivedSignals(fullNames, &linked);
+        if (expanded != fullNames) {
+            bool ok = true;
+            for (auto it = linked.constBegin(); it != linked.constEnd(); ++it) {
+                ok = it.key()->loadSignalsData(it.value()) && ok; // Other dumps are not windowed
+            }
+            return loadSignalsDataInWindow(expanded, startTime, endTimeLimit) && ok;
+        }
+    }
+
+    if (endTimeLimit < startTime) {
+        errorString = QString("Invalid time window: %1 - %2").arg(startTime).arg(endTimeLimit);
+        return false;
+    }
+
+    // Binary mode: offsets must be real byte positions for seeking
+    QFile file(vcdFilename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        errorString = "Cannot open file for signal loading: " + vcdFilename;
+        return false;
+    }
+
+    if (!locateDataSection(file)) {
+        errorString = "No value change section found in: " + vcdFilename;
+        return false;
+    }
+
+    // Requested identifiers; aliases collapse onto one entry
+    QSet<QString> wanted;
+    for (const QString &fullName : fullNames) {
+        QString identifier = identifierOf(fullName);
+        if (!identifier.isEmpty()) {
+            wanted.insert(identifier);
+        }
+    }
+
+    if (wanted.isEmpty()) {
+        return true;
+    }
+
+    const qint64 startOffset = findCheckpointOffset(file, startTime);
+    qDebug() << "Loading" << wanted.size() << "signals in window" << startTime << "-" << endTimeLimit
+             << "from offset" << startOffset;
+
+    // Every value at the start offset, so the forward pass knows each signal
+    // throughout and can leave snapshots at the checkpoints it crosses
+    QHash<QString, QString> current;
+    resolveValuesAt(file, startOffset, wanted, &current);
+
+    // Forward pass: changes inside the window, and the latest value seen before it
+    QMap<QString, QVector<VCDValueChange>> windowChanges;
+    QHash<QString, QString> valueAtStart = current;
+    QString value;
+    QString identifier;
+    int currentTime = 0;
+    int lastTime = 0;
+    bool passedWindow = false;
+    qint64 lastCheckpoint = startOffset;
+
+    file.seek(startOffset);
+    while (!file.atEnd()) {
+        qint64 lineOffset = file.pos();
+        QString line = QString::fromLatin1(file.readLine()).trimmed();
+        if (line.isEmpty()) continue;
+
+        int timestamp = 0;
+        if (parseTimestampLine(line, &timestamp)) {
+            if (lineOffset > startOffset && timeCheckpoints.value(timestamp, -1) == lineOffset) {
+                recordCheckpointValues(lineOffset, current);
+            }
+            if (timestamp > endTimeLimit) {
+                timeCheckpoints.insert(timestamp, lineOffset);
+                recordCheckpointValues(lineOffset, current);
+                passedWindow = true;
+                break;
+            }
+            currentTime = timestamp;
+            lastTime = timestamp;
+
+            if (lineOffset - lastCheckpoint >= CHECKPOINT_SPACING_BYTES) {
+                timeCheckpoints.insert(timestamp, lineOffset);
+                recordCheckpointValues(lineOffset, current);
+                lastCheckpoint = lineOffset;
+            }
+            continue;
+        }
+
+        if (!parseValueChangeLine(line, &value, &identifier) || !wanted.contains(identifier)) {
+            continue;
+        }
+
+        current[identifier] = value;
+        if (currentTime < startTime) {
+            valueAtStart[identifier] = value;
+        } else {
+            VCDValueChange change;
+            change.timestamp = currentTime;
+            change.value = value;
+            windowChanges[identifier].append(change);
+        }
+    }
+
+    // Store: value at the window start first, then the changes inside the window
+    for (const QString &id : wanted) {
+        const QVector<VCDValueChange> inside = windowChanges.value(id);
+
+        QVector<VCDValueChange> changes;
+        auto initial = valueAtStart.constFind(id);
+        if (initial != valueAtStart.constEnd() && !initial.value().isEmpty() &&
+            (inside.isEmpty() || inside.first().timestamp > startTime)) {
+            VCDValueChange change;
+            change.timestamp = startTime;
+            change.value = initial.value();
+            changes.append(change);
+        }
+        changes += inside;
+
+        storeSignalData(id, changes);
+    }
+    SignalCache::instance().enforceLimit();
+
+    endTime = qMax(endTime, passedWindow ? endTimeLimit : lastTime);
+
+    qDebug() << "Window load done," << timeCheckpoints.size() << "checkpoints known";
+    return true;
+}
+
+bool VCDParser::locateDataSection(QFile &file)
+{
+    if (dataStartOffset >= 0) {
+        return true;
+    }
+
+    file.seek(0);
+    while (!file.atEnd()) {
+        qint64 lineOffset = file.pos();
+        QByteArray line = file.readLine().trimmed();
+
+        if (line.startsWith("$enddefinitions")) {
+            dataStartOffset = file.pos();
+            return true;
+        }
+        if (line.startsWith('#')) {
+            dataStartOffset = lineOffset;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// First "#time" line that starts after 'from' and before 'limit'
+bool VCDParser::readTimestampAt(QFile &file, qint64 from, qint64 limit, int *time, qint64 *offset) const
+{
+    file.seek(from);
+    if (from > dataStartOffset) {
+        file.readLine(); // Resynchronise on the next line start
+    }
+
+    while (!file.atEnd() && file.pos() < limit) {
+        qint64 lineOffset = file.pos();
+        QByteArray line = file.readLine();
+
+        if (line.startsWith('#')) {
+            bool ok = false;
+            int value = line.mid(1).trimmed().toInt(&ok);
+            if (ok) {
+                *time = value;
+                *offset = lineOffset;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+// Last "#time" line of the file, read from the tail backwards
+bool VCDParser::readLastTimestamp(QFile &file, int *time) const
+{
+    const qint64 floor = dataStartOffset;
+    qint64 blockEnd = file.size();
+    QByteArray carry;
+    while (blockEnd > floor) {
+        const qint64 blockStart = qMax(floor, blockEnd - WINDOW_BACKSCAN_BYTES);
+        file.seek(blockStart);
+        QByteArray block = file.read(blockEnd - blockStart);
+        block.append(carry);
+
+        // The first line may continue in the block before, keep it for then
+        int from = 0;
+        if (blockStart > floor) {
+            int newline = block.indexOf('\n');
+            if (newline < 0) {
+                carry = block;
+                blockEnd = blockStart;
+                continue;
+            }
+            carry = block.left(newline + 1);
+            from = newline + 1;
+        }
+
+        int end = block.size();
+        while (end > from) {
+            int start = block.lastIndexOf('\n', end - 1) + 1;
+            if (start < from) {
+                start = from;
+            }
+            const QByteArray line = block.mid(start, end - start).trimmed();
+            if (line.startsWith('#')) {
+                bool ok = false;
+                const int value = line.mid(1).toInt(&ok);
+                if (ok) {
+                    *time = value;
+                    return true;
+                }
+            }
+            end = start - 1;
+        }
+
+        blockEnd = blockStart;
+    }
+    return false;
+}
+
+// Offset of the last "#time" line with time <= the requested time
+qint64 VCDParser::findCheckpointOffset(QFile &file, int time)
+{
+    qint64 low = dataStartOffset;
+    qint64 high = file.size();
+    qint64 best = dataStartOffset;
+
+    // Narrow the range with checkpoints found by earlier seeks
+    auto after = timeCheckpoints.upperBound(time);
+    if (after != timeCheckpoints.end()) {
+        high = after.value();
+    }
+    if (after != timeCheckpoints.begin()) {
+        --after;
+        low = best = after.value();
+    }
+
+    // Timestamps grow with the file offset, so bisect on them
+    while (high - low > WINDOW_LINEAR_SCAN_BYTES) {
+        qint64 middle = low + (high - low) / 2;
+
+        int foundTime = 0;
+        qint64 foundOffset = 0;
+        if (!readTimestampAt(file, middle, high, &foundTime, &foundOffset)) {
+            high = middle;
+            continue;
+        }
+
+        timeCheckpoints.insert(foundTime, foundOffset);
+
+        if (foundTime <= time) {
+            low = best = foundOffset;
+        } else {
+            high = middle;
+        }
+    }
+
+    return best;
+}
+
+// Value of each identifier at 'offset' (a "#time" line or the data start),
+// "" for one that has not been assigned yet. Taken from the snapshot there
+// when it has one, else from a short backward scan, else by replaying the
+// file from the nearest earlier snapshot; never guessed.
+void VCDParser::resolveValuesAt(QFile &file, qint64 offset, const QSet<QString> &identifiers,
+                                QHash<QString, QString> *values)
+{
+    QSet<QString> unresolved;
+    const QHash<QString, QString> snapshot = checkpointValues.value(offset);
+    for (const QString &id : identifiers) {
+        auto known = snapshot.constFind(id);
+        if (known != snapshot.constEnd()) {
+            values->insert(id, known.value());
+        } else if (offset <= dataStartOffset) {
+            values->insert(id, QString());
+        } else {
+            unresolved.insert(id);
+        }
+    }
+
+    // Backward pass, block by block: most signals changed shortly before.
+    // A signal that stays quiet for long would turn this into a read of the
+    // whole file, so the pass stops at a bounded distance.
+    const qint64 scanFloor = qMax(dataStartOffset, offset - WINDOW_BACKSCAN_LIMIT_BYTES);
+    qint64 blockEnd = offset;
+    QByteArray carry; // Head of a line that starts in the previous block
+    QString value;
+    QString identifier;
+    while (!unresolved.isEmpty() && blockEnd > scanFloor) {
+        qint64 blockStart = qMax(scanFloor, blockEnd - WINDOW_BACKSCAN_BYTES);
+        file.seek(blockStart);
+        QByteArray block = file.read(blockEnd - blockStart);
+        block.append(carry);
+
+        int from = 0;
+        if (blockStart > dataStartOffset) {
+            int newline = block.indexOf('\n');
+            if (newline < 0) {
+                carry = block;
+                blockEnd = blockStart;
+                continue;
+            }
+            carry = block.left(newline + 1);
+            from = newline + 1;
+        } else {
+            carry.clear();
+        }
+
+        QMap<QString, QString> lastInBlock;
+        while (from < block.size()) {
+            int next = block.indexOf('\n', from);
+            if (next < 0) next = block.size();
+
+            QString line = QString::fromLatin1(block.constData() + from, next - from).trimmed();
+            from = next + 1;
+
+            if (parseValueChangeLine(line, &value, &identifier) && unresolved.contains(identifier)) {
+                lastInBlock[identifier] = value;
+            }
+        }
+
+        for (auto it = lastInBlock.constBegin(); it != lastInBlock.constEnd(); ++it) {
+            values->insert(it.key(), it.value());
+            unresolved.remove(it.key());
+        }
+
+        blockEnd = blockStart;
+    }
+
+    // Down at the $dumpvars block, anything still open was never assigned
+    if (blockEnd <= dataStartOffset) {
+        for (const QString &id : unresolved) {
+            values->insert(id, QString());
+        }
+        unresolved.clear();
+    }
+
+    if (!unresolved.isEmpty()) {
+        // Replay from the nearest snapshot that knows all of them, or from the
+        // data start, leaving snapshots behind so the next load starts closer
+        qint64 replayFrom = dataStartOffset;
+        QHash<QString, QString> replayed;
+        auto it = checkpointValues.lowerBound(offset);
+        while (it != checkpointValues.begin()) {
+            --it;
+            bool covers = true;
+            for (const QString &id : unresolved) {
+                if (!it.value().contains(id)) {
+                    covers = false;
+                    break;
+                }
+            }
+            if (covers) {
+                replayFrom = it.key();
+                break;
+            }
+        }
+        for (const QString &id : unresolved) {
+            replayed.insert(id, replayFrom > dataStartOffset ? checkpointValues.value(replayFrom).value(id) : QString());
+        }
+
+        qDebug() << unresolved.size() << "signals have no change within" << WINDOW_BACKSCAN_LIMIT_BYTES
+                 << "bytes before offset" << offset << ", replaying from offset" << replayFrom;
+
+        qint64 lastCheckpoint = replayFrom;
+        file.seek(replayFrom);
+        while (!file.atEnd() && file.pos() < offset) {
+            qint64 lineOffset = file.pos();
+            QString line = QString::fromLatin1(file.readLine()).trimmed();
+
+            int timestamp = 0;
+            if (parseTimestampLine(line, &timestamp)) {
+                if (lineOffset - lastCheckpoint >= CHECKPOINT_SPACING_BYTES) {
+                    timeCheckpoints.insert(timestamp, lineOffset);
+                    lastCheckpoint = lineOffset;
+                }
+                if (timeCheckpoints.value(timestamp, -1) == lineOffset) {
+                    recordCheckpointValues(lineOffset, replayed);
+                }
+                continue;
+            }
+            if (parseValueChangeLine(line, &value, &identifier) && replayed.contains(identifier)) {
+                replayed[identifier] = value;
+            }
+        }
+
+        for (auto r = replayed.constBegin(); r != replayed.constEnd(); ++r) {
+            values->insert(r.key(), r.value());
+        }
+    }
+
+    if (offset > dataStartOffset) {
+        recordCheckpointValues(offset, *values);
+    }
+}
+
+void VCDParser::recordCheckpointValues(qint64 offset, const QHash<QString, QString> &values)
+{
+    QHash<QString, QString> &snapshot = checkpointValues[offset];
+    for (auto it = values.constBegin(); it != values.constEnd(); ++it) {
+        snapshot.insert(it.key(), it.value());
+    }
+}
+
+QVector<VCDValueChange> VCDParser::getValueChangesForSignal(const QString &fullName)
+{
+    if (derivedSignals.contains(fullName)) {
+        return getDerivedChanges(fullName, 0, getEndTime());
+    }
+
+    const QString identifier = identifierOf(fullName);
+    if (identifier.isEmpty()) {
+        return QVector<VCDValueChange>();
+    }
+
+    // Data that is not loaded yet (or was evicted) comes back through a
+    // background load; this is called while painting, so it never reads the
+    // file itself. Callers that need the data now call loadSignalsData() first.
+    if (!loadedSignals.contains(identifier) && !streamSource) {
+        loadSignalsDataAsync({fullName}); // Skips pending and failed signals
+    }
+
+    // Every access counts as a use for LRU eviction (drawing goes through here)
+    SignalCache::instance().touch(this, identifier);
     
+    return valueChanges.value(identifier);
+}
+
+EdgeIndex VCDParser::getEdgeIndex(const QString &fullName)
+{
+    const QVector<VCDValueChange> changes = getValueChangesForSignal(fullName);
+    if (derivedSignals.contains(fullName)) {
+        return isSignalLoaded(fullName) ? EdgeIndex(changes) : EdgeIndex(); // Not kept: cheap next to the evaluation
+    }
+
+    const QString identifier = identifierOf(fullName);
+    if (!loadedSignals.contains(identifier) && !streamSource) {
+        return EdgeIndex(); // Still on its way from a background load
+    }
+
+    auto it = edgeIndexes.find(identifier);
+    if (it == edgeIndexes.end()) {
+        it = edgeIndexes.insert(identifier, EdgeIndex(changes));
+    }
+    return it.value();
+}
+
+QSharedPointer<const ValueHistogram> VCDParser::getValueHistogram(const QString &fullName)
+{
+    const SignalHandle handle = findSignal(fullName);
+    if (handle == InvalidSignalHandle || signalTable.at(handle).width <= 1) {
+        return QSharedPointer<const ValueHistogram>();
+    }
+
+    const QString identifier = nameTable.at(signalTable.at(handle).identifier);
+    auto it = valueHistograms.constFind(identifier);
+    if (it != valueHistograms.constEnd()) {
+        return it.value();
+    }
+
+    const QVector<VCDValueChange> changes = getValueChangesForSignal(fullName);
+    if (!loadedSignals.contains(identifier) && !streamSource) {
+        return QSharedPointer<const ValueHistogram>(); // Still loading, try again later
+    }
+
+    QSharedPointer<const ValueHistogram> histogram = ValueHistogram::build(changes, endTime);
+    valueHistograms.insert(identifier, histogram);
+    return histogram;
+}
+
+void VCDParser::storeValueHistogram(const QString &fullName, const QSharedPointer<const ValueHistogram> &histogram)
+{
+    const QString identifier = identifierOf(fullName);
+    if (!identifier.isEmpty()) {
+        valueHistograms.insert(identifier, histogram);
+    }
+}
+
+bool VCDParser::isSignalLoaded(const QString &fullName) const
+{
+    auto derived = derivedSignals.constFind(fullName);
+    if (derived != derivedSignals.constEnd()) {
+        if (derived->source) {
+            return derived->source->isSignalLoaded(derived->sourceName);
+        }
+        if (streamSource) {
+            return true; // Streams hold every input already
+        }
+        for (const QString &input : derived->expression->inputs()) {
+            if (!isSignalLoaded(input)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    return loadedSignals.contains(identifierOf(fullName));
+}
+
+bool VCDParser::isSignalLoading(const QString &fullName) const
+{
+    auto derived = derivedSignals.constFind(fullName);
+    if (derived != derivedSignals.constEnd()) {
+        if (derived->source) {
+            return derived->source->isSignalLoading(derived->sourceName);
+        }
+        for (const QString &input : derived->expression->inputs()) {
+            if (isSignalLoading(input)) {
+                return true;
+            }
+        }
+        return false;
+    }
+    return pendingIdentifiers.contains(identifierOf(fullName));
+}
+
+// Derived names are replaced by their inputs and linked rows are moved to
+// 'linked' by dump; everything else is kept
+QList<QString> VCDParser::expandDerivedSignals(const QList<QString> &fullNames,
+                                               QHash<VCDParser *, QList<QString>> *linked) const
+{
+    QList<QString> expanded;
+    for (const QString &fullName : fullNames) {
+        auto derived = derivedSignals.constFind(fullName);
+        if (derived == derivedSignals.constEnd()) {
+            expanded.append(fullName);
+            continue;
+        }
+        if (derived->source) {
+            (*linked)[derived->source].append(derived->sourceName);
+            continue;
+        }
+        for (const QString &input : derived->expression->inputs()) {
+            if (!expanded.contains(input)) {
+                expanded.append(input);
+            }
+        }
+    }
+    return expanded;
+}
+
+bool VCDParser::addDerivedSignal(const QString &name, const QString &expression, VCDSignal *signal)
+{
+    const QString trimmedName = name.trimmed();
+    if (trimmedName.isEmpty()) {
+        errorString = "A derived signal needs a name";
+        return false;
+    }
+    if (findSignal(trimmedName) != InvalidSignalHandle || derivedSignals.contains(trimmedName)) {
+        errorString = QString("A signal named %1 already exists").arg(trimmedName);
+        return false;
+    }
+
+    QSharedPointer<SignalExpression> compiled(new SignalExpression);
+    if (!compiled->compile(expression, *this)) {
+        errorString = compiled->errorString();
+        return false;
+    }
+
+    DerivedSignal derived;
+    derived.expression = compiled;
+    derivedSignals.insert(trimmedName, derived);
+
+    signal->identifier.clear();
+    signal->name = trimmedName;
+    signal->scope.clear();
+    signal->fullName = trimmedName;
+    signal->width = compiled->width();
+    signal->type = "derived";
+    signal->direction.clear();
+
+    qDebug() << "Derived signal" << trimmedName << "=" << compiled->text() << "width" << compiled->width();
+    return true;
+}
+
+QString VCDParser::getDerivedExpression(const QString &fullName) const
+{
+    auto derived = derivedSignals.constFind(fullName);
+    return derived != derivedSignals.constEnd() && derived->expression ? derived->expression->text() : QString();
+}
+
+bool VCDParser::addLinkedSignal(const QString &label, VCDParser *source, const QString &sourceName, VCDSignal *signal)
+{
+    const SignalHandle handle = source->findSignal(sourceName);
+    if (handle == InvalidSignalHandle) {
+        errorString = QString("%1 has no signal %2").arg(label, sourceName);
+        return false;
+    }
+
+    const QString name = label + ":" + sourceName;
+    if (findSignal(name) != InvalidSignalHandle) {
+        errorString = QString("A signal named %1 already exists").arg(name);
+        return false;
+    }
+
+    // Adding the same row again reuses it; any other entry of that name is a clash
+    auto existing = derivedSignals.constFind(name);
+    if (existing != derivedSignals.constEnd() &&
+        (existing->source != source || existing->sourceName != sourceName)) {
+        errorString = QString("A signal named %1 already exists").arg(name);
+        return false;
+    }
+
+    if (existing == derivedSignals.constEnd()) {
+        DerivedSignal linked;
+        linked.source = source;
+        linked.sourceName = sourceName;
+        derivedSignals.insert(name, linked);
+    }
+    if (!linkedOffsets.contains(source)) {
+        linkedOffsets.insert(source, 0);
+        connect(source, &VCDParser::signalsDataLoaded, this, &VCDParser::signalsDataLoaded, Qt::UniqueConnection);
+    }
+
+    *signal = source->getSignal(handle);
+    signal->fullName = name;
+    signal->scope = signal->scope.isEmpty() ? label : label + ":" + signal->scope;
+    return true;
+}
+
+void VCDParser::removeLinkedSignals(VCDParser *source)
+{
+    for (auto it = derivedSignals.begin(); it != derivedSignals.end();) {
+        if (it->source == source) {
+            it = derivedSignals.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    linkedOffsets.remove(source);
+    disconnect(source, &VCDParser::signalsDataLoaded, this, &VCDParser::signalsDataLoaded);
+}
+
+void VCDParser::setLinkedTimeOffset(VCDParser *source, int offset)
+{
+    if (!linkedOffsets.contains(source)) {
+        return;
+    }
+    linkedOffsets[source] = offset;
+    for (DerivedSignal &derived : derivedSignals) {
+        if (derived.source == source) {
+            derived.cacheValid = false;
+            derived.cache.clear();
+        }
+    }
+}
+
+int VCDParser::getEndTime() const
+{
+    int end = endTime;
+    for (auto it = linkedOffsets.constBegin(); it != linkedOffsets.constEnd(); ++it) {
+        end = qMax(end, it.key()->getEndTime() + it.value());
+    }
+    return end;
+}
+
+QVector<VCDValueChange> VCDParser::getDerivedChanges(const QString &fullName, int from, int to)
+{
+    auto it = derivedSignals.find(fullName);
+    if (it == derivedSignals.end()) {
+        return QVector<VCDValueChange>();
+    }
+
+    if (it->cacheValid && it->cachedFrom <= from && to <= it->cachedTo) {
+        return it->cache;
+    }
+
+    if (it->source) {
+        return getLinkedChanges(fullName, from, to);
+    }
+
+    // Loading inputs touches the parser's tables, so look the entry up again after
+    const QSharedPointer<SignalExpression> expression = it->expression;
+    const QStringList inputs = expression->inputs();
+    QVector<QVector<VCDValueChange>> inputChanges;
+    inputChanges.reserve(inputs.size());
+    bool complete = true;
+    for (const QString &input : inputs) {
+        inputChanges.append(getValueChangesForSignal(input));
+        if (!streamSource && !loadedSignals.contains(identifierOf(input))) {
+            complete = false; // Still on its way from a background load
+        }
+    }
+
+    // Evaluate a range three times as wide as asked, so small scrolls and
+    // zooms stay inside the cache
+    const qint64 span = qint64(to) - from;
+    const int windowFrom = int(qMax<qint64>(0, from - span));
+    const int windowTo = int(qMin<qint64>(INT_MAX, to + span));
+    const QVector<VCDValueChange> changes = expression->evaluate(inputChanges, windowFrom, windowTo);
+
+    // Point lookups (the values column) are cheap and would only push the
+    // drawn range out of the cache
+    it = derivedSignals.find(fullName);
+    if (complete && from < to && it != derivedSignals.end()) {
+        it->cache = changes;
+        it->cachedFrom = windowFrom;
+        it->cachedTo = windowTo;
+        it->cacheValid = true;
+    }
+    return changes;
+}
+
+// A linked row without an offset is the other dump's data itself, shared
+// and not copied; with one, the range asked for (plus the same margins as a
+// derived signal) is shifted onto this dump's time axis
+QVector<VCDValueChange> VCDParser::getLinkedChanges(const QString &fullName, int from, int to)
+{
+    DerivedSignal &linked = derivedSignals[fullName];
+    const QVector<VCDValueChange> changes = linked.source->getValueChangesForSignal(linked.sourceName);
+    const int offset = linkedOffsets.value(linked.source);
+    if (offset == 0) {
+        return changes;
+    }
+
+    const qint64 span = qint64(to) - from;
+    const int windowFrom = int(qMax<qint64>(0, from - span));
+    const int windowTo = int(qMin<qint64>(INT_MAX, to + span));
+    const int sourceFrom = int(qBound<qint64>(INT_MIN, qint64(windowFrom) - offset, INT_MAX));
+    const int sourceTo = int(qBound<qint64>(INT_MIN, qint64(windowTo) - offset, INT_MAX));
+
+    // Start with the value held at the window start
+    const int first = qMax(0, EdgeIndex::upperBound(changes, sourceFrom) - 1);
+    const int last = EdgeIndex::upperBound(changes, sourceTo);
+    QVector<VCDValueChange> shifted;
+    shifted.reserve(qMax(0, last - first));
+    for (int i = first; i < last; i++) {
+        VCDValueChange change = changes[i];
+        change.timestamp += offset;
+        shifted.append(change);
+    }
+
+    if (from < to && linked.source->isSignalLoaded(linked.sourceName)) {
+        linked.cache = shifted;
+        linked.cachedFrom = windowFrom;
+        linked.cachedTo = windowTo;
+        linked.cacheValid = true;
+    }
+    return shifted;
+}
+
+void VCDParser::parseTimescale(const QString &line)
+{
+    QRegularExpression regex("^\\$timescale\\s+(\\S+)\\s*\\$end$");
+    QRegularExpressionMatch match = regex.match(line);
     if (match.hasMatch()) {
-        VCDSignal signal;
-        signal.type = match.captured(1);
-        signal.width = match.captured(2).toInt();
-        signal.identifier = match.captured(3);
-        
-        QString signalName = match.captured(4).trimmed();
-        signal.name = signalName;
-        signal.scope = currentScope;
-        signal.fullName = generateFullName(currentScope, signalName);
-
-        vcdSignals.append(signal);
-        
-        // Store in both maps
-        identifierMap[signal.identifier] = signal;
-        fullNameMap[signal.fullName] = signal;
-        
-        // qDebug() << "Parsed signal - Full:" << signal.fullName 
-        //          << "ID:" << signal.identifier 
-        //          << "Scope:" << signal.scope 
-        //          << "Name:" << signal.name;
+        timescale = match.captured(1);
+        qDebug() << "Timescale:" << timescale;
+    }
+}
+
+void VCDParser::parseScopeLine(const QString &line)
+{
+    // "$scope <type> <name> $end"
+    QStringList tokens = splitHeaderTokens(line);
+    if (tokens.size() < 4 || tokens.last() != "$end") {
+        return;
     }
+
+    // Re-opening a scope continues the existing node
+    quint32 name = intern(tokens.at(2));
+    quint64 key = (quint64(currentScope) << 32) | name;
+    auto it = scopeChildIndex.constFind(key);
+    if (it != scopeChildIndex.constEnd()) {
+        currentScope = it.value();
+        return;
+    }
+
+    ScopeEntry scope;
+    scope.parent = currentScope;
+    scope.name = name;
+    currentScope = scopeTable.size();
+    scopeTable.append(scope);
+    scopeChildIndex.insert(key, currentScope);
+}
+
+void VCDParser::parseVarLine(const QString &line)
+{
+    // "$var <type> <width> <identifier> <name> [range] $end"
+    QStringList tokens = splitHeaderTokens(line);
+    if (tokens.size() < 6 || tokens.last() != "$end") {
+        return;
+    }
+
+    bool ok = false;
+    int width = tokens.at(2).toInt(&ok);
+    if (!ok) {
+        return;
+    }
+
+    // A bit range after the name stays part of it, as in "data [7:0]"
+    QString signalName = tokens.at(4);
+    for (int i = 5; i < tokens.size() - 1; ++i) {
+        signalName += ' ' + tokens.at(i);
+    }
+
+    SignalEntry entry;
+    entry.scope = currentScope;
+    entry.name = intern(signalName);
+    entry.identifier = intern(tokens.at(3));
+    entry.type = intern(tokens.at(1));
+    entry.width = width;
+    entry.direction = NoDirection;
+
+    SignalHandle handle = signalTable.size();
+    signalTable.append(entry);
+
+    // Index by alias and by full name; the name itself is never stored
+    identifierMap[entry.identifier].append(handle);
+    fullNameIndex.insert(qHash(getFullName(handle)), handle);
 }
\ No newline at end of file
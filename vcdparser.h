@@ -8,6 +8,14 @@
 #include <QFile>
 #include <QTextStream>
 #include <QSet>
+#include <QIODevice>
+#include <QAtomicInt>
+#include <QHash>
+#include <QSharedPointer>
+#include <QFuture>
+#include <QThreadPool>
+#include "edgeindex.h"
+#include "valuehistogram.h"
 
 struct VCDSignal {
     QString identifier;
@@ -16,6 +24,7 @@ struct VCDSignal {
     int width;
     QString type;
     QString fullName;  // ADD THIS: unique identifier for the signal
+    QString direction; // NEW: "input", "output" or "inout" from the RTL, empty if unknown
 
     bool operator==(const VCDSignal& other) const {
         return fullName == other.fullName;  // Compare using fullName instead of identifier
@@ -24,6 +33,27 @@ struct VCDSignal {
 
 Q_DECLARE_METATYPE(VCDSignal)
 
+// NEW: 32-bit index into the parser's signal table
+typedef quint32 SignalHandle;
+static const SignalHandle InvalidSignalHandle = 0xFFFFFFFFu;
+
+// NEW: Scope hierarchy, built once the definitions are parsed. Scopes are
+// indices into the parser's scope table (0 is the root). Signals are listed
+// in signalOrder grouped by scope with scopes in preorder, so both a scope's
+// own signals and its whole subtree are contiguous ranges.
+struct VCDScopeTree {
+    QVector<int> childBegin;        // Children of s: childScopes[childBegin[s] .. childBegin[s + 1])
+    QVector<quint32> childScopes;   // In declaration order
+    QVector<int> childRow;          // Position of each scope among its parent's children
+    QVector<int> signalBegin;       // Own signals of s: signalOrder[signalBegin[s] .. signalEnd[s])
+    QVector<int> signalEnd;
+    QVector<int> subtreeEnd;        // s and all descendants: signalOrder[signalBegin[s] .. subtreeEnd[s])
+    QVector<SignalHandle> signalOrder;
+};
+
+class SignalNameIndex;
+class SignalExpression;
+
 struct VCDValueChange {
     int timestamp;
     QString value;
@@ -41,36 +71,240 @@ public:
     bool parseHeaderOnly(const QString &filename); // Fast header-only parsing
     QString getError() const { return errorString; }
 
-    const QVector<VCDSignal>& getSignals() const { return vcdSignals; }
+    // CHANGE: the header is kept as an interned table; VCDSignal values are
+    // built on request. getSignals() materializes every signal, so prefer
+    // getSignalCount()/getSignal()/findSignal() on large designs.
+    QVector<VCDSignal> getSignals() const;
+    int getSignalCount() const { return signalTable.size(); }
+    VCDSignal getSignal(SignalHandle handle) const;
+    SignalHandle findSignal(const QString &fullName) const;
+    QString getFullName(SignalHandle handle) const;
+
+    // NEW: Field access for views that must not build a VCDSignal per row.
+    // Scope 0 is the unnamed root and a parent always precedes its children.
+    int getScopeCount() const { return scopeTable.size(); }
+    quint32 getScopeParent(quint32 scope) const { return scopeTable.at(scope).parent; }
+    QString getScopeName(quint32 scope) const { return nameTable.at(scopeTable.at(scope).name); }
+    QString getScopePath(quint32 scope) const { return scopePath(scope); }
+    quint32 getSignalScope(SignalHandle handle) const { return signalTable.at(handle).scope; }
+    QString getSignalName(SignalHandle handle) const { return nameTable.at(signalTable.at(handle).name); }
+    QString getSignalType(SignalHandle handle) const { return nameTable.at(signalTable.at(handle).type); }
+    QString getSignalIdentifier(SignalHandle handle) const { return nameTable.at(signalTable.at(handle).identifier); }
+    int getSignalWidth(SignalHandle handle) const { return signalTable.at(handle).width; }
+    const VCDScopeTree& getScopeTree() const { return scopeTree; }
+
+    // NEW: Port directions found in the RTL sources (see RtlPortScanner).
+    // They live beside the header table and are dropped when it is re-read.
+    QString getSignalDirection(SignalHandle handle) const;
+    void setSignalDirection(SignalHandle handle, const QString &direction);
+    void clearPortDirections();
+    bool hasPortDirections() const { return portDirectionCount > 0; }
+    // NEW: Substring search over full names, built with the scope tree
+    const SignalNameIndex& getNameIndex() const { return *signalNameIndex; }
+
     QVector<VCDValueChange> getValueChangesForSignal(const QString &fullName);  // CHANGE: use fullName
-    const QMap<QString, VCDSignal>& getIdentifierMap() const { return identifierMap; }
-    const QMap<QString, VCDSignal>& getFullNameMap() const { return fullNameMap; }  // ADD THIS
-    int getEndTime() const { return endTime; }
+
+    // NEW: Rise/fall rank-select index over the signal's value changes, built
+    // once per load (loading the data first if needed)
+    EdgeIndex getEdgeIndex(const QString &fullName);
+
+    // NEW: Distinct-value histogram of a bus, built on first use and kept
+    // until the file or time window changes (it survives cache eviction).
+    // Null for scalars and for buses with too many distinct values.
+    QSharedPointer<const ValueHistogram> getValueHistogram(const QString &fullName);
+    bool hasValueHistogramEntry(const QString &fullName) const { return valueHistograms.contains(identifierOf(fullName)); }
+    QSharedPointer<const ValueHistogram> cachedValueHistogram(const QString &fullName) const { return valueHistograms.value(identifierOf(fullName)); }
+    void storeValueHistogram(const QString &fullName, const QSharedPointer<const ValueHistogram> &histogram);
+    // CHANGE: every alias sharing an identifier, not just the last one
+    QList<QString> getAliases(const QString &fullName) const;
+    int getEndTime() const; // CHANGE: also covers rows linked from other dumps
+    bool isSignalLoaded(const QString &fullName) const;
     
     // Load specific signals on demand
     bool loadSignalsData(const QList<QString> &fullNames);  // CHANGE: use fullNames
 
+    // NEW: Background load for many signals at once. The data section is
+    // split at "#time" lines and the pieces are scanned in parallel on the
+    // thread pool; the result is stored on this object's thread and
+    // signalsDataLoaded() is emitted. Signals already loaded or on their way
+    // are skipped. getValueChangesForSignal() never blocks: a signal that is
+    // missing comes back empty and is requested here. Time windows are loaded
+    // by seeking rather than on the pool, from the event loop after the call.
+    // Signals whose load failed stay unloaded until the file is read again.
+    void loadSignalsDataAsync(const QList<QString> &fullNames);
+    bool isSignalLoading(const QString &fullName) const;
+
+    // NEW: Derived signals, computed from an expression over other signals
+    // (see SignalExpression). They are named like real signals and go
+    // through getValueChangesForSignal() and the load calls above, which
+    // stand in for their inputs. Views should ask getDerivedChanges() for
+    // just the time range on screen; results are cached per range until the
+    // data changes. Derived signals are dropped with the header.
+    bool addDerivedSignal(const QString &name, const QString &expression, VCDSignal *signal);
+    void removeDerivedSignal(const QString &name) { derivedSignals.remove(name); }
+    bool isDerivedSignal(const QString &fullName) const { return derivedSignals.contains(fullName); }
+    QString getDerivedExpression(const QString &fullName) const;
+    QVector<VCDValueChange> getDerivedChanges(const QString &fullName, int from, int to);
+
+    // NEW: Rows from another open dump, named "label:full.name" and shifted
+    // by a per-dump time offset. They work like derived signals whose only
+    // input lives in the other parser, which keeps its own lazily loaded
+    // store; every parser shares SignalCache's memory budget.
+    bool addLinkedSignal(const QString &label, VCDParser *source, const QString &sourceName, VCDSignal *signal);
+    void removeLinkedSignals(VCDParser *source);
+    void setLinkedTimeOffset(VCDParser *source, int offset);
+    int getLinkedTimeOffset(VCDParser *source) const { return linkedOffsets.value(source); }
+
+    // NEW: Streaming ingestion from a named pipe, or stdin when source is "-".
+    // Blocks until the writer closes the stream or cancelStream() is called,
+    // so run it on a worker thread: readStream() does, on a pool of this
+    // parser's own, since a silent pipe must not hold a global pool thread.
+    bool parseStream(const QString &source);
+    QFuture<bool> readStream(const QString &source);
+    void cancelStream();
+    bool isStreamSource() const { return streamSource; }
+
+    // NEW: Time-window loading for huge dumps. While a window is set,
+    // loadSignalsData() keeps only the changes inside [startTime, endTime]
+    // plus the value each signal holds at startTime.
+    void setTimeWindow(int startTime, int endTime);
+    void clearTimeWindow();
+    bool hasTimeWindow() const { return windowEnd >= 0; }
+    int getWindowStart() const { return windowStart; }
+    int getWindowEnd() const { return windowEnd; }
+    bool loadSignalsDataInWindow(const QList<QString> &fullNames, int startTime, int endTime);
+
+signals:
+    void streamHeaderReady();             // Definitions parsed, signals can be added
+    void streamDataAppended(int endTime); // A batch of value changes was stored
+    void streamHistoryTrimmed(int fromTime); // Over the memory budget, older changes were dropped
+    void signalsDataLoaded();             // A loadSignalsDataAsync() request was stored
+
 private:
+    friend class SignalCache;
+    void evictSignalData(const QString &identifier); // Called by SignalCache
+    void storeSignalData(const QString &identifier, const QVector<VCDValueChange> &changes);
+    QString identifierOf(const QString &fullName) const;
+    void clearSignalData();
+
     bool parseHeader(QTextStream &stream);
+    bool processHeaderLine(const QString &line);
+    void adoptStreamHeader(VCDParser *header, const QSet<QString> &knownIdentifiers, int generation);
+    void reportStreamError(const QString &message, int generation);
+    void appendStreamBatch(const QMap<QString, QVector<VCDValueChange>> &batch, int batchEndTime, int generation);
+    void trimStreamHistory(qint64 targetBytes);
+    bool locateDataSection(QFile &file);
+    bool readTimestampAt(QFile &file, qint64 from, qint64 limit, int *time, qint64 *offset) const;
+    bool readLastTimestamp(QFile &file, int *time) const;
+    qint64 findCheckpointOffset(QFile &file, int time);
+    void resolveValuesAt(QFile &file, qint64 offset, const QSet<QString> &identifiers, QHash<QString, QString> *values);
+    void recordCheckpointValues(qint64 offset, const QHash<QString, QString> &values);
     bool parseValueChangesForSignals(QTextStream &stream, const QSet<QString> &signalsToLoad);
+
+    // One piece of a parallel load: changes of the wanted identifiers between
+    // two "#time" lines of the data section
+    struct ChunkScan {
+        QHash<QString, QVector<VCDValueChange>> changes;
+        int lastTime = 0;
+        bool ok = false;
+    };
+    struct AsyncLoad {
+        int generation;
+        int chunksLeft;
+        QVector<ChunkScan> chunks;
+        QSet<QString> identifiers;
+    };
+    static ChunkScan scanDataChunk(const QString &filename, qint64 from, qint64 to, qint64 dataStart,
+                                   const QSet<QString> &wanted);
+    void finishDataChunk(int loadId, int chunk, const ChunkScan &scan);
     void parseScopeLine(const QString &line);
     void parseVarLine(const QString &line);
     void parseTimescale(const QString &line);
-    QString generateFullName(const QString &scope, const QString &name);  // ADD THIS
+    void clearHeaderTable();
+    void buildScopeTree();
+    quint32 intern(const QString &text);
+    QString scopePath(quint32 scope) const;
+    bool matchesFullName(SignalHandle handle, const QString &fullName) const;
+    QList<QString> expandDerivedSignals(const QList<QString> &fullNames,
+                                        QHash<VCDParser *, QList<QString>> *linked) const;
+    QVector<VCDValueChange> getLinkedChanges(const QString &fullName, int from, int to);
+
+    // Interned header table. Every distinct name, identifier and type string
+    // is stored once in nameTable; scopes and signals refer to it by index.
+    struct ScopeEntry {
+        quint32 parent; // Index into scopeTable, root is its own parent
+        quint32 name;   // Index into nameTable
+    };
+    struct SignalEntry {
+        quint32 scope;
+        quint32 name;
+        quint32 identifier;
+        quint32 type;
+        int width;
+        quint32 direction; // Index into nameTable, NoDirection until RTL is applied
+    };
+    static const quint32 NoDirection = 0xFFFFFFFFu;
 
     QString errorString;
-    QVector<VCDSignal> vcdSignals;
-    QMap<QString, VCDSignal> identifierMap;
-    QMap<QString, VCDSignal> fullNameMap;  // ADD THIS: maps fullName -> VCDSignal
+    QVector<QString> nameTable;
+    QHash<QString, quint32> nameIndex;
+    QVector<ScopeEntry> scopeTable;          // Entry 0 is the unnamed root
+    QHash<quint64, quint32> scopeChildIndex; // (parent << 32 | name) -> scope
+    QVector<SignalEntry> signalTable;
+    QMultiHash<uint, SignalHandle> fullNameIndex;           // qHash(fullName) -> handle
+    QHash<quint32, QVector<SignalHandle>> identifierMap;    // identifier -> all aliases
+    int portDirectionCount;
+    VCDScopeTree scopeTree;
+    SignalNameIndex *signalNameIndex;
     
-    // Data storage
+    // Data storage, once per VCD identifier: aliases share the same changes
     QMap<QString, QVector<VCDValueChange>> valueChanges;
-    QSet<QString> loadedSignals; // Track which signals have data loaded
+    QSet<QString> loadedSignals; // Identifiers whose data is loaded
+    QHash<QString, EdgeIndex> edgeIndexes; // Built on first navigation, dropped with the data
+    QHash<QString, QSharedPointer<const ValueHistogram>> valueHistograms; // Null: too many values
+
+    // Derived signals by name, each with the last range it was evaluated for
+    struct DerivedSignal {
+        QSharedPointer<SignalExpression> expression; // Null for linked rows
+        VCDParser *source = nullptr;                 // Linked rows: the other dump
+        QString sourceName;
+        bool cacheValid = false;
+        int cachedFrom = 0;
+        int cachedTo = 0;
+        QVector<VCDValueChange> cache;
+    };
+    QHash<QString, DerivedSignal> derivedSignals;
+    QHash<VCDParser *, int> linkedOffsets; // Every dump rows are linked from, with its offset
+
+    // Background loads in flight; results of an older generation are dropped
+    QHash<int, AsyncLoad> asyncLoads;
+    QSet<QString> pendingIdentifiers;
+    QSet<QString> failedIdentifiers;       // Background load failed, not retried until reload
+    QList<QFuture<void>> asyncLoadFutures; // Waited for on destruction
+    int nextAsyncLoadId;
+    int asyncLoadGeneration;
     
-    QString currentScope;
+    quint32 currentScope;
     int endTime;
     QString timescale;
     QString vcdFilename;
+
+    // Streaming state
+    bool skippingHeaderBlock;    // Inside $date/$version/$comment
+    bool streamSource;           // Data came from a pipe and cannot be re-read
+    QAtomicInt streamGeneration; // Bumped to cancel a running stream
+    qint64 streamBytes;          // Held by streamed changes, pinned in SignalCache
+    QThreadPool streamReaders;   // Threads running parseStream()
+
+    // Time window state
+    int windowStart;
+    int windowEnd;                     // -1 when the whole dump is loaded
+    qint64 dataStartOffset;            // First byte after $enddefinitions, -1 if unknown
+    QMap<int, qint64> timeCheckpoints; // Timestamp -> file offset of its "#" line
+
+    // NEW: Value of each signal at a checkpoint's file offset, for the
+    // signals window loads have read past it; "" when it has none yet
+    QMap<qint64, QHash<QString, QString>> checkpointValues;
 };
 
 #endif // VCDPARSER_H
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "waveformwidget.h"
+#include "signalnameindex.h"
 #include <QScrollBar>
 #include <QWheelEvent>
 #include <QMouseEvent>
@@ -9,6 +10,8 @@
 #include <QInputDialog>
 #include <QApplication>
 #include <cmath>
+#include <climits>
+#include <algorithm>
 
 WaveformWidget::WaveformWidget(QWidget *parent)
     : QWidget(parent),
@@ -36,8 +39,7 @@ WaveformWidget::WaveformWidget(QWidget *parent)
       verticalOffset(0),
       isSearchActive(false),
       signalCursorIndex(-1),  
-      showSignalCursor(false), 
-      MAX_CACHED_SIGNALS(1000)
+      showSignalCursor(false)
 {
     qDebug() << "WaveformWidget constructor started";
     setFocusPolicy(Qt::StrongFocus);
@@ -66,6 +68,16 @@ void WaveformWidget::setVcdData(VCDParser *parser)
 {
     vcdParser = parser;
     displayItems.clear();
+    fitAfterLoad = false;
+    cycleClock.clear();
+    clockEdges.clear();
+    cycleSamples.clear();
+
+    if (vcdParser)
+    {
+        connect(vcdParser, &VCDParser::signalsDataLoaded, this, &WaveformWidget::onSignalsDataLoaded,
+                Qt::UniqueConnection);
+    }
 
     // Reset zoom to safe levels when loading new data
     if (timeScale > 100.0 || timeScale < 0.01)
@@ -90,6 +102,18 @@ void WaveformWidget::setVcdData(VCDParser *parser)
     update();
 }
 
+void WaveformWidget::refreshTimeRange()
+{
+    // Called while a stream is still appending data: keep zoom and scroll
+    // position, only extend the scrollable range and repaint
+    if (!cycleClock.isEmpty())
+    {
+        buildClockEdges(); // New edges, and samples over them
+    }
+    updateScrollBar();
+    update();
+}
+
 const DisplayItem *WaveformWidget::getItem(int index) const
 {
     if (index >= 0 && index < displayItems.size())
@@ -135,6 +159,34 @@ void WaveformWidget::removeSelectedSignals()
     emit itemSelected(-1);
 }
 
+void WaveformWidget::removeSignals(const QSet<QString> &fullNames)
+{
+    bool removed = false;
+    for (int index = displayItems.size() - 1; index >= 0; index--)
+    {
+        const DisplayItem &item = displayItems[index];
+        if (item.type != DisplayItem::Signal || !fullNames.contains(item.signal.signal.fullName))
+            continue;
+
+        displayItems.removeAt(index);
+        removed = true;
+        if (signalCursorIndex > index)
+        {
+            signalCursorIndex--;
+        }
+    }
+    if (!removed)
+        return;
+
+    // Indices after the removed rows have moved
+    selectedItems.clear();
+    lastSelectedItem = -1;
+    updateSignalCursorAfterChanges();
+
+    update();
+    emit itemSelected(-1);
+}
+
 void WaveformWidget::selectAllSignals()
 {
     selectedItems.clear();
@@ -261,11 +313,23 @@ void WaveformWidget::zoomFit()
 
     int availableWidth = width() - signalNamesWidth - valuesColumnWidth - 20;
 
+    // NEW: A partially loaded dump fits its time window, not the whole range
+    if (vcdParser->hasTimeWindow() && availableWidth > 10)
+    {
+        double windowRange = qMax(1.0, timeToAxis(vcdParser->getWindowEnd()) - timeToAxis(vcdParser->getWindowStart()));
+        timeScale = qMax(0.001, qMin(1000.0, availableWidth / windowRange));
+        timeOffset = static_cast<int>(timeToAxis(vcdParser->getWindowStart()) * timeScale);
+
+        updateScrollBar();
+        update();
+        return;
+    }
+
     // Use the same margins as scrolling - UPDATE THIS LINE:
     const int LEFT_MARGIN = 0;   // -10 time units (negative time)
     const int RIGHT_MARGIN = 10; // 100 time units after end
 
-    int totalTimeRange = vcdParser->getEndTime() + RIGHT_MARGIN - LEFT_MARGIN; // Note: subtract LEFT_MARGIN because it's negative
+    double totalTimeRange = timeToAxis(vcdParser->getEndTime()) + RIGHT_MARGIN - LEFT_MARGIN; // Note: subtract LEFT_MARGIN because it's negative
 
     if (availableWidth <= 10)
     {
@@ -277,7 +341,7 @@ void WaveformWidget::zoomFit()
     }
     else
     {
-        timeScale = static_cast<double>(availableWidth) / totalTimeRange;
+        timeScale = availableWidth / totalTimeRange;
     }
 
     timeScale = qMax(0.001, qMin(1000.0, timeScale));
@@ -454,6 +518,8 @@ void WaveformWidget::paintEvent(QPaintEvent *event)
         return;
     }
 
+    requestVisibleSignalData();
+
     drawSignalNamesColumn(painter);
     drawSignalValuesColumn(painter, cursorTime);
     drawWaveformArea(painter);
@@ -602,16 +668,36 @@ void WaveformWidget::drawWaveformArea(QPainter &painter)
     painter.setPen(QPen(QColor(80, 80, 80), 1, Qt::DotLine));
     int startTime = xToTime(0);
     int endTime = xToTime(width() - waveformStartX);
-    int timeStep = calculateTimeStep(startTime, endTime);
 
-    for (int time = (startTime / timeStep) * timeStep; time <= endTime; time += timeStep)
+    if (isCycleView())
     {
-        int x = timeToX(time);
-        painter.drawLine(waveformStartX + x, 0, waveformStartX + x, timeMarkersHeight);
+        // NEW: Cycle numbers at the clock edges instead of times
+        int startCycle = qMax(0, cycleAtTime(startTime));
+        int endCycle = cycleAtTime(endTime) + 1;
+        int cycleStep = calculateTimeStep(startCycle, endCycle, CYCLE_AXIS_UNITS);
+        for (int cycle = (startCycle / cycleStep) * cycleStep; cycle <= endCycle; cycle += cycleStep)
+        {
+            int x = timeToX(cycleStartTime(cycle));
+            painter.drawLine(waveformStartX + x, 0, waveformStartX + x, timeMarkersHeight);
 
-        painter.setPen(QPen(Qt::white));
-        painter.drawText(waveformStartX + x + 2, timeMarkersHeight - 5, QString::number(time));
-        painter.setPen(QPen(QColor(80, 80, 80), 1, Qt::DotLine));
+            painter.setPen(QPen(Qt::white));
+            painter.drawText(waveformStartX + x + 2, timeMarkersHeight - 5, QString("C%1").arg(cycle));
+            painter.setPen(QPen(QColor(80, 80, 80), 1, Qt::DotLine));
+        }
+    }
+    else
+    {
+        int timeStep = calculateTimeStep(startTime, endTime);
+
+        for (int time = (startTime / timeStep) * timeStep; time <= endTime; time += timeStep)
+        {
+            int x = timeToX(time);
+            painter.drawLine(waveformStartX + x, 0, waveformStartX + x, timeMarkersHeight);
+
+            painter.setPen(QPen(Qt::white));
+            painter.drawText(waveformStartX + x + 2, timeMarkersHeight - 5, QString::number(time));
+            painter.setPen(QPen(QColor(80, 80, 80), 1, Qt::DotLine));
+        }
     }
 
     // Set up clipping for scrollable waveform area (exclude pinned timeline)
@@ -672,6 +758,58 @@ void WaveformWidget::drawTimeCursor(QPainter &painter)
     painter.drawLine(waveformStartX + cursorX, timeMarkersHeight, waveformStartX + cursorX, drawHeight);
 }
 
+// NEW: Reload visible signals evicted from the cache, or not loaded yet, in
+// one background pass over the file instead of one pass per row when each row
+// asks for its data. Rows already on their way are skipped by the parser.
+void WaveformWidget::requestVisibleSignalData()
+{
+    if (!vcdParser)
+        return;
+
+    QList<QString> missing;
+    int y = 0;
+    int visibleTop = verticalOffset;
+    int visibleBottom = verticalOffset + (height() - timeMarkersHeight);
+    for (const auto &item : displayItems)
+    {
+        int itemHeight = (item.type == DisplayItem::Signal) ? signalHeight : 30;
+        if (y > visibleBottom)
+            break;
+        if (y + itemHeight >= visibleTop && item.type == DisplayItem::Signal &&
+            !vcdParser->isSignalLoaded(item.signal.signal.fullName))
+        {
+            missing.append(item.signal.signal.fullName);
+        }
+        y += itemHeight;
+    }
+    if (!missing.isEmpty())
+    {
+        vcdParser->loadSignalsDataAsync(missing);
+    }
+}
+
+void WaveformWidget::onSignalsDataLoaded()
+{
+    // NEW: The clock of the cycle view may just have arrived
+    if (!cycleClock.isEmpty() && clockEdges.isEmpty())
+    {
+        buildClockEdges();
+        if (isCycleView())
+            zoomFit();
+    }
+
+    if (fitAfterLoad && vcdParser && vcdParser->getEndTime() > 0)
+    {
+        fitAfterLoad = false;
+        zoomFit();
+    }
+    else
+    {
+        updateScrollBar();
+    }
+    update();
+}
+
 void WaveformWidget::drawSignals(QPainter &painter)
 {
     // FIXED: Start at position 0 since we're already translated
@@ -700,6 +838,15 @@ void WaveformWidget::drawSignals(QPainter &painter)
         {
             const VCDSignal &signal = item.signal.signal;
 
+            // NEW: Placeholder until the background load delivers this row
+            if (vcdParser->isSignalLoading(signal.fullName))
+            {
+                painter.setPen(QColor(110, 110, 110));
+                painter.drawText(QRect(5, currentY, 200, itemHeight), Qt::AlignVCenter | Qt::AlignLeft, "Loading...");
+                currentY += itemHeight;
+                continue;
+            }
+
             // FIXED: Draw at the currentY position (no additional offset needed)
             if (signal.width > 1)
             {
@@ -709,16 +856,208 @@ void WaveformWidget::drawSignals(QPainter &painter)
             {
                 drawSignalWaveform(painter, signal, currentY);
             }
+
+            auto overlay = mismatchOverlays.constFind(signal.fullName);
+            if (overlay != mismatchOverlays.constEnd())
+            {
+                drawMismatchOverlay(painter, overlay.value(), currentY);
+            }
         }
 
         currentY += itemHeight;
     }
 }
 
+// NEW: Red bands over the mismatching stretches, and a marker at the first
+void WaveformWidget::drawMismatchOverlay(QPainter &painter, const QVector<SignalDiff::Interval> &mismatches, int yPos)
+{
+    if (mismatches.isEmpty())
+        return;
+
+    int waveformStartX = signalNamesWidth + valuesColumnWidth;
+    int visibleStart = xToTime(0);
+    int visibleEnd = xToTime(width() - waveformStartX);
+
+    // Skip to the first band that reaches the screen
+    auto first = std::lower_bound(mismatches.constBegin(), mismatches.constEnd(), visibleStart,
+                                  [](const SignalDiff::Interval &interval, int time) { return interval.end < time; });
+    for (auto it = first; it != mismatches.constEnd() && it->start <= visibleEnd; ++it)
+    {
+        int x1 = timeToX(it->start);
+        int x2 = qMax(x1 + 1, timeToX(it->end));
+        painter.fillRect(x1, yPos, x2 - x1, signalHeight, QColor(255, 0, 0, 70));
+    }
+
+    int firstX = timeToX(mismatches.first().start);
+    painter.setPen(QPen(QColor(255, 60, 60), 2));
+    painter.drawLine(firstX, yPos, firstX, yPos + signalHeight);
+}
+
+void WaveformWidget::setMismatchOverlay(const QString &fullName, const QVector<SignalDiff::Interval> &mismatches)
+{
+    mismatchOverlays.insert(fullName, mismatches);
+    update();
+}
+
+void WaveformWidget::clearMismatchOverlays()
+{
+    mismatchOverlays.clear();
+    update();
+}
+
+void WaveformWidget::setCycleClock(const QString &fullName)
+{
+    cycleClock = fullName;
+    buildClockEdges();
+    if (!cycleClock.isEmpty() && !isCycleView())
+    {
+        qDebug() << "Cycle view: no rising edges on" << cycleClock << "yet";
+    }
+
+    zoomFit();
+    if (showCursor)
+        navigateToTime(cursorTime);
+    emit timeChanged(cursorTime);
+}
+
+// Rising edges come from the clock's edge index: the k-th rise is a select
+void WaveformWidget::buildClockEdges()
+{
+    clockEdges.clear();
+    cycleSamples.clear();
+    if (!vcdParser || cycleClock.isEmpty())
+        return;
+
+    const QVector<VCDValueChange> changes = vcdParser->getValueChangesForSignal(cycleClock);
+    const EdgeIndex index = vcdParser->getEdgeIndex(cycleClock);
+    const int rises = index.count(EdgeIndex::Rise);
+    clockEdges.reserve(rises);
+    for (int k = 0; k < rises; k++)
+    {
+        int time = changes[index.position(EdgeIndex::Rise, k)].timestamp;
+        if (clockEdges.isEmpty() || time > clockEdges.last())
+            clockEdges.append(time); // Several rises in one time step make one cycle
+    }
+    qDebug() << "Cycle view on" << cycleClock << ":" << clockEdges.size() << "rising edges";
+}
+
+int WaveformWidget::cycleAtTime(int time) const
+{
+    return std::upper_bound(clockEdges.constBegin(), clockEdges.constEnd(), time) - clockEdges.constBegin();
+}
+
+// Cycle c runs from cycleStartTime(c) to cycleStartTime(c + 1). Cycle 0 is
+// the time before the first edge and the last real cycle ends at the end of
+// the dump; beyond that cycles keep the length of the last one.
+int WaveformWidget::cycleStartTime(int cycle) const
+{
+    const int edges = clockEdges.size();
+    if (cycle <= 0)
+        return 0;
+    if (cycle <= edges)
+        return clockEdges[cycle - 1];
+
+    int tailEnd = qMax(vcdParser ? vcdParser->getEndTime() : 0, clockEdges.last() + 1);
+    if (cycle == edges + 1)
+        return tailEnd;
+    qint64 tailLength = tailEnd - clockEdges.last();
+    return static_cast<int>(qMin<qint64>(INT_MAX, tailEnd + (cycle - edges - 1) * tailLength));
+}
+
+// Axis position of a time: the time itself, or in cycle view the cycle
+// number plus the fraction of the cycle gone by
+double WaveformWidget::timeToAxis(int time) const
+{
+    if (clockEdges.isEmpty())
+        return time;
+
+    const int edges = clockEdges.size();
+    if (time < 0)
+        return CYCLE_AXIS_UNITS * time / qMax(1, cycleStartTime(1));
+
+    int cycle = cycleAtTime(time);
+    int start = cycleStartTime(cycle);
+    int end = cycleStartTime(cycle + 1);
+    if (cycle == edges && time >= end)
+    {
+        // Past the end of the dump
+        int length = qMax(1, end - start);
+        return CYCLE_AXIS_UNITS * (edges + 1 + double(time - end) / length);
+    }
+    return CYCLE_AXIS_UNITS * (cycle + double(time - start) / qMax(1, end - start));
+}
+
+int WaveformWidget::axisToTime(double axis) const
+{
+    if (clockEdges.isEmpty())
+        return static_cast<int>(axis);
+
+    double cycles = axis / CYCLE_AXIS_UNITS;
+    int cycle = static_cast<int>(std::floor(cycles));
+    if (cycle < 0)
+        return static_cast<int>(cycles * qMax(1, cycleStartTime(1)));
+
+    cycle = qMin(cycle, clockEdges.size() + 1);
+    int start = cycleStartTime(cycle);
+    int length = qMax(1, cycleStartTime(cycle + 1) - start);
+    return static_cast<int>(qBound(-1e9, start + (cycles - cycle) * length, 1e9));
+}
+
+// NEW: A signal as seen by the clock: the value just before each rising edge,
+// held for the following cycle. The edges and the changes are walked
+// together once; the result is kept until the clock or the data changes.
+QVector<VCDValueChange> WaveformWidget::sampledValueChanges(const QString &fullName) const
+{
+    auto cached = cycleSamples.constFind(fullName);
+    if (cached != cycleSamples.constEnd())
+        return cached.value();
+
+    const QVector<VCDValueChange> changes = vcdParser->getValueChangesForSignal(fullName);
+    QVector<VCDValueChange> samples;
+    if (!changes.isEmpty())
+    {
+        samples.append(changes.first()); // Cycle 0: the initial value
+        const QString *held = &changes.first().value;
+        int next = 0;
+        for (int edge : clockEdges)
+        {
+            while (next < changes.size() && changes[next].timestamp < edge)
+                held = &changes[next++].value;
+
+            if (*held != samples.last().value)
+            {
+                VCDValueChange sample;
+                sample.timestamp = edge;
+                sample.value = *held;
+                samples.append(sample);
+            }
+        }
+    }
+
+    if (vcdParser->isSignalLoaded(fullName) || vcdParser->isStreamSource())
+        cycleSamples.insert(fullName, samples);
+    return samples;
+}
+
+// NEW: Derived signals are only evaluated around the time range on screen
+QVector<VCDValueChange> WaveformWidget::visibleValueChanges(const QString &fullName) const
+{
+    if (isCycleView() && fullName != cycleClock)
+    {
+        return sampledValueChanges(fullName);
+    }
+    if (vcdParser->isDerivedSignal(fullName))
+    {
+        int waveformStartX = signalNamesWidth + valuesColumnWidth;
+        return vcdParser->getDerivedChanges(fullName, qMax(0, xToTime(0)), xToTime(width() - waveformStartX));
+    }
+    return vcdParser->getValueChangesForSignal(fullName);
+}
+
 void WaveformWidget::drawSignalWaveform(QPainter &painter, const VCDSignal &signal, int yPos)
 {
     // Use lazy loading to get value changes
-    const auto changes = vcdParser->getValueChangesForSignal(signal.fullName);
+    const auto changes = visibleValueChanges(signal.fullName);
     if (changes.isEmpty())
         return;
 
@@ -757,8 +1096,9 @@ void WaveformWidget::drawSignalWaveform(QPainter &painter, const VCDSignal &sign
     int lowLevel = signalBottom;  // Bottom of the waveform area
     int middleLevel = signalMidY; // Middle for X/Z values
 
-    int prevTime = 0;
-    QString prevValue = "0";
+    // NEW: With a time window the data starts at the window, not at time 0
+    int prevTime = vcdParser->hasTimeWindow() ? changes.first().timestamp : 0;
+    QString prevValue = vcdParser->hasTimeWindow() ? changes.first().value : QString("0");
     int prevX = timeToX(prevTime);
 
     for (const auto &change : changes)
@@ -964,7 +1304,7 @@ void WaveformWidget::drawCleanTransition(QPainter &painter, int x, int top, int
 void WaveformWidget::drawBusWaveform(QPainter &painter, const VCDSignal &signal, int yPos)
 {
     // Use lazy loading to get value changes
-    const auto changes = vcdParser->getValueChangesForSignal(signal.fullName);
+    const auto changes = visibleValueChanges(signal.fullName);
     if (changes.isEmpty())
         return;
 
@@ -1000,8 +1340,8 @@ void WaveformWidget::drawBusWaveform(QPainter &painter, const VCDSignal &signal,
     int textY = busMidY + 4;
     int waveformHeight = busBottom - busTop; // This should now be identical to signal waveform height
 
-    int prevTime = 0;
-    QString prevValue = getBusValueAtTime(signal.fullName, 0);
+    int prevTime = vcdParser->hasTimeWindow() ? changes.first().timestamp : 0;
+    QString prevValue = getBusValueAtTime(signal.fullName, prevTime);
     int prevX = timeToX(prevTime);
 
     // Draw clean bus background - but make it the same visual thickness
@@ -1085,7 +1425,8 @@ void WaveformWidget::drawBusWaveform(QPainter &painter, const VCDSignal &signal,
 
     // Draw clean bus outline - use currentLineWidth for selected signals
     painter.setPen(QPen(signalColor, currentLineWidth));
-    painter.drawRect(timeToX(0), busTop, endX - timeToX(0), waveformHeight);
+    int startX = timeToX(vcdParser->hasTimeWindow() ? changes.first().timestamp : 0);
+    painter.drawRect(startX, busTop, endX - startX, waveformHeight);
 }
 
 void WaveformWidget::updateScrollBar()
@@ -1109,7 +1450,7 @@ void WaveformWidget::updateScrollBar()
     // Horizontal scrolling (unchanged)
     const int LEFT_MARGIN_PIXELS = static_cast<int>(-10 * timeScale);
     const int RIGHT_MARGIN_PIXELS = static_cast<int>(100 * timeScale);
-    int timelinePixelWidth = static_cast<int>(vcdParser->getEndTime() * timeScale);
+    int timelinePixelWidth = static_cast<int>(timeToAxis(vcdParser->getEndTime()) * timeScale);
     int totalPixelWidth = timelinePixelWidth + LEFT_MARGIN_PIXELS + RIGHT_MARGIN_PIXELS;
     int maxScrollOffset = qMax(0, totalPixelWidth - viewportWidth);
 
@@ -1174,7 +1515,7 @@ int WaveformWidget::timeToX(int time) const
         return 0;
 
     // Convert time to pixels, then subtract the scroll offset
-    double pixelPosition = time * timeScale;
+    double pixelPosition = timeToAxis(time) * timeScale;
     double result = pixelPosition - timeOffset;
 
     // Clamp to safe integer range
@@ -1204,13 +1545,15 @@ int WaveformWidget::xToTime(int x) const
     if (result < -1000000000)
         return -1000000000;
 
-    return static_cast<int>(result);
+    return axisToTime(result);
 }
 
 QString WaveformWidget::getSignalValueAtTime(const QString &fullName, int time) const // CHANGE: parameter name
 {
     // Use lazy loading - use fullName
-    const auto changes = vcdParser->getValueChangesForSignal(fullName); // CHANGE: use fullName
+    const auto changes = isCycleView() && fullName != cycleClock   ? sampledValueChanges(fullName)
+                         : vcdParser->isDerivedSignal(fullName) ? vcdParser->getDerivedChanges(fullName, time, time)
+                                                                : vcdParser->getValueChangesForSignal(fullName); // CHANGE: use fullName
     QString value = "0";
 
     for (const auto &change : changes)
@@ -1226,7 +1569,9 @@ QString WaveformWidget::getSignalValueAtTime(const QString &fullName, int time)
 QString WaveformWidget::getBusValueAtTime(const QString &fullName, int time) const // CHANGE: parameter name
 {
     // Use lazy loading - use fullName
-    const auto changes = vcdParser->getValueChangesForSignal(fullName); // CHANGE: use fullName
+    const auto changes = isCycleView() && fullName != cycleClock   ? sampledValueChanges(fullName)
+                         : vcdParser->isDerivedSignal(fullName) ? vcdParser->getDerivedChanges(fullName, time, time)
+                                                                : vcdParser->getValueChangesForSignal(fullName); // CHANGE: use fullName
     QString value = "0";
 
     for (const auto &change : changes)
@@ -1239,14 +1584,18 @@ QString WaveformWidget::getBusValueAtTime(const QString &fullName, int time) con
     return value;
 }
 
-int WaveformWidget::calculateTimeStep(int startTime, int endTime) const
+// NEW: 'axisUnitsPerStep' is the axis width of one counted unit (a whole
+// clock cycle in cycle view)
+int WaveformWidget::calculateTimeStep(int startTime, int endTime, double axisUnitsPerStep) const
 {
     int timeRange = endTime - startTime;
     if (timeRange <= 0)
         return 100;
 
     double pixelsPerStep = 100.0;
-    double targetStep = pixelsPerStep / timeScale;
+    double targetStep = pixelsPerStep / (timeScale * axisUnitsPerStep);
+    if (targetStep <= 1.0)
+        return 1; // Never below one unit, or the ruler loop would not advance
 
     double power = std::pow(10, std::floor(std::log10(targetStep)));
     double normalized = targetStep / power;
@@ -1298,6 +1647,9 @@ void WaveformWidget::handleMultiSelection(int itemIndex, QMouseEvent *event)
         lastSelectedItem = itemIndex;
     }
 
+    // NEW: Next/previous follow every selected signal
+    forceNavigationUpdate();
+
     update();
     emit itemSelected(itemIndex);
 }
@@ -1753,24 +2105,22 @@ void WaveformWidget::setVisibleSignals(const QList<VCDSignal> &visibleSignals)
         timeOffset = 0;
     }
 
-    displayItems.clear();
-
-    // Load data for the selected signals
-    if (vcdParser && !visibleSignals.isEmpty())
+    // NEW: Rows are built in one batch and shown right away as placeholders;
+    // their data is loaded in the background and fills them in as it lands
+    QList<DisplayItem> items;
+    items.reserve(visibleSignals.size());
+    QList<QString> fullNames;
+    fullNames.reserve(visibleSignals.size());
+    for (const auto &signal : visibleSignals)
     {
-        QList<QString> fullNames; // CHANGE: use fullNames
-        for (const auto &signal : visibleSignals)
-        {
-            fullNames.append(signal.fullName); // CHANGE: use fullName
-        }
-
-        // Load signal data before displaying
-        vcdParser->loadSignalsData(fullNames); // This now uses fullNames
+        items.append(DisplayItem::createSignal(signal));
+        fullNames.append(signal.fullName);
     }
+    displayItems = std::move(items);
 
-    for (const auto &signal : visibleSignals)
+    if (vcdParser && !fullNames.isEmpty())
     {
-        displayItems.append(DisplayItem::createSignal(signal));
+        vcdParser->loadSignalsDataAsync(fullNames);
     }
     selectedItems.clear();
     lastSelectedItem = -1;
@@ -1778,10 +2128,14 @@ void WaveformWidget::setVisibleSignals(const QList<VCDSignal> &visibleSignals)
     // NEW: Initialize cursor to last signal if we have signals
     updateSignalCursorAfterChanges();
 
-    // Auto-zoom to fit after adding signals
+    // Auto-zoom to fit after adding signals. The end time is only known once
+    // value changes have been read, so a first load fits when it lands.
     if (!visibleSignals.isEmpty())
     {
-        zoomFit();
+        if (vcdParser && vcdParser->getEndTime() > 0)
+            zoomFit();
+        else
+            fitAfterLoad = true;
     }
 
     updateScrollBar();
@@ -2053,7 +2407,6 @@ void WaveformWidget::resetNavigationForCurrentSignal()
 
     // Update the current index based on cursor position
     int newIndex = findEventIndexForTime(cursorTime, currentlyNavigatedSignal);
-    signalCurrentEventIndex[currentlyNavigatedSignal] = newIndex;
     currentEventIndex = newIndex;
 
     qDebug() << "Reset navigation: Signal" << currentlyNavigatedSignal
@@ -2472,12 +2825,27 @@ void WaveformWidget::updateSearchResults()
     }
     else
     {
-        // Filter signals based on search text
+        // Filter signals based on search text. The parser's name index gives
+        // the candidates; only those are checked against the displayed path.
         QString searchLower = searchText.toLower();
+        QBitArray candidates;
+        if (vcdParser && !vcdParser->getNameIndex().isEmpty())
+        {
+            candidates = vcdParser->getNameIndex().search(searchLower);
+        }
+
         for (int i = 0; i < displayItems.size(); i++)
         {
             if (displayItems[i].type == DisplayItem::Signal)
             {
+                // Derived and linked rows are not in the index; they get the plain test
+                if (!candidates.isEmpty())
+                {
+                    SignalHandle handle = vcdParser->findSignal(displayItems[i].signal.signal.fullName);
+                    if (handle != InvalidSignalHandle && !candidates.testBit(handle))
+                        continue;
+                }
+
                 QString signalName = displayItems[i].getFullPath().toLower();
                 if (signalName.contains(searchLower))
                 {
@@ -2519,23 +2887,11 @@ void WaveformWidget::applySearchFilter()
 // Update the signal loading functions to use fullName
 void WaveformWidget::ensureSignalLoaded(const QString &fullName) // CHANGE: parameter name
 {
-    if (!loadedSignalIdentifiers.contains(fullName)) // CHANGE: use fullName
+    // The parser reloads evicted signals; memory is bounded by SignalCache
+    if (vcdParser && !vcdParser->isSignalLoaded(fullName))
     {
-        // Load the signal data
         QList<QString> signalsToLoad = {fullName};
         vcdParser->loadSignalsData(signalsToLoad);
-        loadedSignalIdentifiers.insert(fullName); // CHANGE: use fullName
-
-        // Manage cache size
-        if (loadedSignalIdentifiers.size() > MAX_CACHED_SIGNALS)
-        {
-            // Remove least recently used signal
-            if (!loadedSignalIdentifiers.isEmpty())
-            {
-                QString oldestSignal = *loadedSignalIdentifiers.begin();
-                loadedSignalIdentifiers.remove(oldestSignal);
-            }
-        }
     }
 }
 
@@ -2543,10 +2899,12 @@ void WaveformWidget::setNavigationMode(NavigationMode mode)
 {
     navigationMode = mode;
 
-    // Clear ALL cached events when navigation mode changes
-    signalEventTimestamps.clear();
-    signalCurrentEventIndex.clear();
+    // The edge index covers every mode; only the position has to be found again
     currentlyNavigatedSignal.clear();
+    navigationChanges.clear();
+    navigationIndex = EdgeIndex();
+    navigationTracks.clear();
+    mergeDirection = 0;
     currentEventIndex = -1;
 
     // Force update events immediately when mode changes
@@ -2588,7 +2946,7 @@ void WaveformWidget::navigateToTime(int targetTime)
         // So: (cursorTime * timeScale) - timeOffset = viewportWidth / 2
         // Therefore: timeOffset = (cursorTime * timeScale) - viewportWidth / 2
 
-        timeOffset = (cursorTime * timeScale) - (viewportWidth / 2);
+        timeOffset = (timeToAxis(cursorTime) * timeScale) - (viewportWidth / 2);
 
         // Clamp to valid range
         timeOffset = qMax(0, timeOffset);
@@ -2599,7 +2957,7 @@ void WaveformWidget::navigateToTime(int targetTime)
         qDebug() << "  Cursor time:" << cursorTime;
         qDebug() << "  Time scale:" << timeScale;
         qDebug() << "  Viewport width:" << viewportWidth;
-        qDebug() << "  Calculated offset:" << (cursorTime * timeScale) - (viewportWidth / 2);
+        qDebug() << "  Calculated offset:" << (timeToAxis(cursorTime) * timeScale) - (viewportWidth / 2);
         qDebug() << "  Final offset:" << timeOffset;
 
         // Update scrollbar
@@ -2629,56 +2987,53 @@ void WaveformWidget::navigateToPreviousEvent()
     qDebug() << "=== PREVIOUS BUTTON CLICKED ===";
     qDebug() << "Currently navigated signal:" << currentlyNavigatedSignal;
 
-    if (currentlyNavigatedSignal.isEmpty() || !signalEventTimestamps.contains(currentlyNavigatedSignal))
+    if (isMultiSignalNavigation())
     {
-        qDebug() << "No signal selected for navigation";
+        stepMergedEvent(-1);
         return;
     }
 
-    QVector<int> &events = signalEventTimestamps[currentlyNavigatedSignal];
-    int &currentIndex = signalCurrentEventIndex[currentlyNavigatedSignal];
+    if (currentlyNavigatedSignal.isEmpty())
+    {
+        qDebug() << "No signal selected for navigation";
+        return;
+    }
 
-    qDebug() << "Events count:" << events.size();
-    qDebug() << "Current index:" << currentIndex;
-    qDebug() << "Current cursor time:" << cursorTime;
+    const int events = eventCount();
+    qDebug() << "Events count:" << events << "Current index:" << currentEventIndex << "Cursor time:" << cursorTime;
 
-    if (events.isEmpty())
+    if (events == 0)
     {
         qDebug() << "No events found for signal";
         return;
     }
 
     // If no current index set, find where we are based on cursor time
-    if (currentIndex == -1)
+    if (currentEventIndex == -1)
     {
-        currentIndex = findEventIndexForTime(cursorTime, currentlyNavigatedSignal);
-        qDebug() << "Setting initial current index to:" << currentIndex;
+        currentEventIndex = findEventIndexForTime(cursorTime);
     }
 
     // If we're before the first event, go to the first event
-    if (currentIndex == -1)
+    if (currentEventIndex == -1)
     {
-        currentIndex = 0;
-        int targetTime = events[currentIndex];
-        currentEventIndex = currentIndex;
-
-        qDebug() << "Previous: Before first event, going to first event at index" << currentIndex << "Time:" << targetTime;
-        navigateToTime(targetTime);
+        currentEventIndex = 0;
+        qDebug() << "Previous: Before first event, going to first event";
+        navigateToTime(eventTime(currentEventIndex));
         return;
     }
 
     // If we're at the beginning, don't move
-    if (currentIndex <= 0)
+    if (currentEventIndex <= 0)
     {
         qDebug() << "Already at first event, cannot go previous";
         return;
     }
 
-    currentIndex--;
-    int targetTime = events[currentIndex];
-    currentEventIndex = currentIndex;
+    currentEventIndex--;
+    int targetTime = eventTime(currentEventIndex);
 
-    qDebug() << "Previous: Moving to index" << currentIndex << "Time:" << targetTime;
+    qDebug() << "Previous: Moving to index" << currentEventIndex << "Time:" << targetTime;
     navigateToTime(targetTime);
 }
 
@@ -2687,100 +3042,204 @@ void WaveformWidget::navigateToNextEvent()
     qDebug() << "=== NEXT BUTTON CLICKED ===";
     qDebug() << "Currently navigated signal:" << currentlyNavigatedSignal;
 
-    if (currentlyNavigatedSignal.isEmpty() || !signalEventTimestamps.contains(currentlyNavigatedSignal))
+    if (isMultiSignalNavigation())
     {
-        qDebug() << "No signal selected for navigation";
+        stepMergedEvent(+1);
         return;
     }
 
-    QVector<int> &events = signalEventTimestamps[currentlyNavigatedSignal];
-    int &currentIndex = signalCurrentEventIndex[currentlyNavigatedSignal];
+    if (currentlyNavigatedSignal.isEmpty())
+    {
+        qDebug() << "No signal selected for navigation";
+        return;
+    }
 
-    qDebug() << "Events count:" << events.size();
-    qDebug() << "Current index:" << currentIndex;
-    qDebug() << "Current cursor time:" << cursorTime;
+    const int events = eventCount();
+    qDebug() << "Events count:" << events << "Current index:" << currentEventIndex << "Cursor time:" << cursorTime;
 
-    if (events.isEmpty())
+    if (events == 0)
     {
         qDebug() << "No events found for signal";
         return;
     }
 
     // If no current index set, find where we are based on cursor time
-    if (currentIndex == -1)
+    if (currentEventIndex == -1)
     {
-        currentIndex = findEventIndexForTime(cursorTime, currentlyNavigatedSignal);
-        qDebug() << "Setting initial current index to:" << currentIndex;
+        currentEventIndex = findEventIndexForTime(cursorTime);
     }
 
     // If we're before the first event, go to the first event
-    if (currentIndex == -1)
+    if (currentEventIndex == -1)
     {
-        currentIndex = 0;
-        int targetTime = events[currentIndex];
-        currentEventIndex = currentIndex;
-
-        qDebug() << "Next: Before first event, going to first event at index" << currentIndex << "Time:" << targetTime;
-        navigateToTime(targetTime);
+        currentEventIndex = 0;
+        qDebug() << "Next: Before first event, going to first event";
+        navigateToTime(eventTime(currentEventIndex));
         return;
     }
 
     // If we're at the end, don't move
-    if (currentIndex >= events.size() - 1)
+    if (currentEventIndex >= events - 1)
     {
         qDebug() << "Already at last event, cannot go next";
         return;
     }
 
-    currentIndex++;
-    int targetTime = events[currentIndex];
-    currentEventIndex = currentIndex;
+    currentEventIndex++;
+    int targetTime = eventTime(currentEventIndex);
 
-    qDebug() << "Next: Moving to index" << currentIndex << "Time:" << targetTime;
+    qDebug() << "Next: Moving to index" << currentEventIndex << "Time:" << targetTime;
     navigateToTime(targetTime);
 }
 
 bool WaveformWidget::hasPreviousEvent() const
 {
-    if (currentlyNavigatedSignal.isEmpty() || !signalEventTimestamps.contains(currentlyNavigatedSignal))
+    if (isMultiSignalNavigation())
+    {
+        // Any selected signal with an event before the cursor
+        for (const NavigationTrack &track : navigationTracks)
+        {
+            if (track.index.rank(navigationKind(), EdgeIndex::upperBound(track.changes, cursorTime - 1)) > 0)
+                return true;
+        }
         return false;
+    }
 
-    const QVector<int> &events = signalEventTimestamps[currentlyNavigatedSignal];
-    int currentIndex = signalCurrentEventIndex.value(currentlyNavigatedSignal, -1);
-
-    if (events.isEmpty())
+    if (currentlyNavigatedSignal.isEmpty() || eventCount() == 0)
         return false;
 
     // If we're before the first event, no previous available
-    if (currentIndex == -1)
+    return currentEventIndex > 0;
+}
+
+bool WaveformWidget::hasNextEvent() const
+{
+    if (isMultiSignalNavigation())
     {
+        // Any selected signal with an event after the cursor
+        for (const NavigationTrack &track : navigationTracks)
+        {
+            const EdgeIndex::Kind kind = navigationKind();
+            if (track.index.rank(kind, EdgeIndex::upperBound(track.changes, cursorTime)) < track.index.count(kind))
+                return true;
+        }
         return false;
     }
 
-    // If we're at the first event but there are multiple events, we can go to previous (which would be before first)
-    // OR if we're after the first event, we can go to previous event
-    return currentIndex > 0;
+    if (currentlyNavigatedSignal.isEmpty() || eventCount() == 0)
+        return false;
+
+    // If we're before the first event, we can go to the first event
+    if (currentEventIndex == -1)
+    {
+        return true;
+    }
+
+    return currentEventIndex < eventCount() - 1;
 }
 
-bool WaveformWidget::hasNextEvent() const
+bool WaveformWidget::trackEventTime(const NavigationTrack &track, int event, int *time) const
 {
-    if (currentlyNavigatedSignal.isEmpty() || !signalEventTimestamps.contains(currentlyNavigatedSignal))
+    const int change = track.index.position(navigationKind(), event);
+    if (change < 0)
         return false;
 
-    const QVector<int> &events = signalEventTimestamps[currentlyNavigatedSignal];
-    int currentIndex = signalCurrentEventIndex.value(currentlyNavigatedSignal, -1);
+    *time = track.changes[change].timestamp;
+    return true;
+}
 
-    if (events.isEmpty())
-        return false;
+// Heap order: earliest time on top going forward, latest going back
+static bool mergeCursorAfter(int direction, int a, int b)
+{
+    return direction > 0 ? a > b : a < b;
+}
 
-    // If we're before the first event, we can go to the first event
-    if (currentIndex == -1)
+void WaveformWidget::buildMergeHeap(int direction)
+{
+    mergeHeap.clear();
+    const EdgeIndex::Kind kind = navigationKind();
+
+    for (int i = 0; i < navigationTracks.size(); i++)
     {
-        return true;
+        const NavigationTrack &track = navigationTracks[i];
+
+        // First event after the cursor, or last one before it
+        int event = direction > 0
+                        ? track.index.rank(kind, EdgeIndex::upperBound(track.changes, cursorTime))
+                        : track.index.rank(kind, EdgeIndex::upperBound(track.changes, cursorTime - 1)) - 1;
+
+        MergeCursor cursor;
+        cursor.track = i;
+        cursor.event = event;
+        if (trackEventTime(track, event, &cursor.time))
+        {
+            mergeHeap.append(cursor);
+        }
     }
 
-    // If we're at or before the last event, we can go next
-    return currentIndex < events.size() - 1;
+    std::make_heap(mergeHeap.begin(), mergeHeap.end(), [direction](const MergeCursor &a, const MergeCursor &b)
+                   { return mergeCursorAfter(direction, a.time, b.time); });
+
+    mergeDirection = direction;
+    mergeTime = cursorTime;
+}
+
+void WaveformWidget::stepMergedEvent(int direction)
+{
+    // Reuse the heap while stepping the same way from where it left off;
+    // a moved cursor or a turn costs one O(N log n) rebuild
+    if (mergeDirection != direction || mergeTime != cursorTime)
+    {
+        buildMergeHeap(direction);
+    }
+
+    if (mergeHeap.isEmpty())
+    {
+        qDebug() << "No further events on the" << navigationTracks.size() << "selected signals";
+        return;
+    }
+
+    auto after = [direction](const MergeCursor &a, const MergeCursor &b)
+    { return mergeCursorAfter(direction, a.time, b.time); };
+
+    // Every signal changing at the target time moves past it together
+    const int targetTime = mergeHeap.first().time;
+    while (!mergeHeap.isEmpty() && mergeHeap.first().time == targetTime)
+    {
+        std::pop_heap(mergeHeap.begin(), mergeHeap.end(), after);
+        MergeCursor cursor = mergeHeap.takeLast();
+
+        cursor.event += direction;
+        if (trackEventTime(navigationTracks[cursor.track], cursor.event, &cursor.time))
+        {
+            mergeHeap.append(cursor);
+            std::push_heap(mergeHeap.begin(), mergeHeap.end(), after);
+        }
+    }
+
+    qDebug() << (direction > 0 ? "Next" : "Previous") << "event on any selected signal at time:" << targetTime;
+    navigateToTime(targetTime);
+    mergeTime = cursorTime;
+}
+
+EdgeIndex::Kind WaveformWidget::navigationKind() const
+{
+    switch (navigationMode)
+    {
+    case SignalRise:
+        return EdgeIndex::Rise;
+    case SignalFall:
+        return EdgeIndex::Fall;
+    case ValueChange:
+    default:
+        return EdgeIndex::AnyChange;
+    }
+}
+
+int WaveformWidget::eventTime(int event) const
+{
+    int change = navigationIndex.position(navigationKind(), event);
+    return change >= 0 ? navigationChanges[change].timestamp : cursorTime;
 }
 
 void WaveformWidget::updateEventList()
@@ -2804,82 +3263,66 @@ void WaveformWidget::updateEventList()
     // Store which signal we're navigating
     currentlyNavigatedSignal = signal.fullName;
 
-    const auto changes = vcdParser->getValueChangesForSignal(signal.fullName);
-    if (changes.isEmpty())
+    // Navigation needs the data now, not after a background load; one pass
+    // over the file brings in every selected row that is missing
+    QList<QString> selectedNames;
+    for (int row : selectedItems)
     {
-        qDebug() << "No value changes found for signal:" << signal.fullName;
-        return;
+        if (isSignalItem(row))
+            selectedNames.append(displayItems[row].signal.signal.fullName);
     }
+    vcdParser->loadSignalsData(selectedNames);
 
-    // Always recompute events to ensure they're up to date
-    QVector<int> events;
-
-    QString prevValue;
+    // Built by the parser once per load and shared by every mode
+    navigationChanges = vcdParser->getValueChangesForSignal(signal.fullName);
+    navigationIndex = vcdParser->getEdgeIndex(signal.fullName);
+    if (navigationIndex.changeCount() != navigationChanges.size())
+    {
+        navigationIndex = EdgeIndex(navigationChanges); // Data changed since the index was taken
+    }
 
-    qDebug() << "=== PROCESSING EVENTS FOR MODE:" << navigationMode << "===";
-    qDebug() << "Signal:" << signal.fullName;
-    qDebug() << "Total changes:" << changes.size();
+    currentEventIndex = findEventIndexForTime(cursorTime);
 
-    for (int i = 0; i < changes.size(); i++)
+    // Every other selected signal joins the merged navigation
+    navigationTracks.clear();
+    mergeDirection = 0;
+    if (selectedItems.size() > 1)
     {
-        const auto &change = changes[i];
-        bool includeEvent = false;
-
-        switch (navigationMode)
+        QList<int> rows = selectedItems.values();
+        std::sort(rows.begin(), rows.end());
+        for (int row : rows)
         {
-        case ValueChange:
-            includeEvent = true;
-            break;
-
-        case SignalRise:
-            if (i > 0)
-            {
-                includeEvent = (prevValue == "0" && change.value == "1");
-            }
-            break;
+            if (!isSignalItem(row))
+                continue;
 
-        case SignalFall:
-            if (i > 0)
+            NavigationTrack track;
+            track.fullName = displayItems[row].signal.signal.fullName;
+            track.changes = vcdParser->getValueChangesForSignal(track.fullName);
+            track.index = vcdParser->getEdgeIndex(track.fullName);
+            if (track.index.changeCount() != track.changes.size())
             {
-                includeEvent = (prevValue == "1" && change.value == "0");
+                track.index = EdgeIndex(track.changes);
             }
-            break;
-        }
-
-        if (includeEvent)
-        {
-            events.append(change.timestamp);
-            qDebug() << "  Including event at time:" << change.timestamp << "value:" << change.value;
+            navigationTracks.append(track);
         }
-
-        prevValue = change.value;
     }
 
-    // Store events for this signal
-    signalEventTimestamps[signal.fullName] = events;
-
-    // Set current index based on cursor position for this signal
-    int newIndex = findEventIndexForTime(cursorTime, signal.fullName);
-    signalCurrentEventIndex[signal.fullName] = newIndex;
-    currentEventIndex = newIndex;
-
-    qDebug() << "=== NAVIGATION SUMMARY ===";
-    qDebug() << "Signal:" << signal.fullName;
-    qDebug() << "Mode:" << navigationMode;
-    qDebug() << "Total changes:" << changes.size();
-    qDebug() << "Navigation events found:" << events.size();
-    qDebug() << "Cursor time:" << cursorTime;
-    qDebug() << "Current index:" << newIndex;
-    qDebug() << "Events list:" << events;
-    qDebug() << "=== END SUMMARY ===";
+    qDebug() << "Navigation: Signal" << signal.fullName
+             << "Tracks:" << navigationTracks.size()
+             << "Mode:" << navigationMode
+             << "Changes:" << navigationChanges.size()
+             << "Events:" << eventCount()
+             << "Current index:" << currentEventIndex;
 }
 
 void WaveformWidget::forceNavigationUpdate()
 {
     // Clear all navigation state
-    signalEventTimestamps.clear();
-    signalCurrentEventIndex.clear();
     currentlyNavigatedSignal.clear();
+    navigationChanges.clear();
+    navigationIndex = EdgeIndex();
+    navigationTracks.clear();
+    mergeDirection = 0;
     currentEventIndex = -1;
 
     // Force update if we have selected signals
@@ -2892,39 +3335,14 @@ void WaveformWidget::forceNavigationUpdate()
     emit timeChanged(cursorTime);
 }
 
+// Last event at or before 'time': a binary search over the change times and
+// a rank over the edge bitmap of the current mode
 int WaveformWidget::findEventIndexForTime(int time, const QString &signalFullName) const
 {
-    if (!signalEventTimestamps.contains(signalFullName))
-        return -1;
-
-    const QVector<int> &events = signalEventTimestamps[signalFullName];
-
-    if (events.isEmpty())
-        return -1;
-
-    // If we're before the first event, return -1 to indicate we're before any event
-    if (time < events.first())
-    {
+    if (signalFullName != currentlyNavigatedSignal)
         return -1;
-    }
-
-    // If we're after the last event, return the last event index
-    if (time > events.last())
-    {
-        return events.size() - 1;
-    }
-
-    // Find the event that is closest to but not greater than the current time
-    for (int i = events.size() - 1; i >= 0; i--)
-    {
-        if (events[i] <= time)
-        {
-            return i;
-        }
-    }
 
-    // Should never reach here, but return -1 if we do
-    return -1;
+    return navigationIndex.edgeAtOrBefore(navigationKind(), navigationChanges, time);
 }
 
 // Overload for currently navigated signal
@@ -2937,9 +3355,9 @@ int WaveformWidget::findEventIndexForTime(int time) const
 
 int WaveformWidget::getCurrentEventTime() const
 {
-    if (currentEventIndex >= 0 && currentEventIndex < eventTimestamps.size())
+    if (currentEventIndex >= 0 && currentEventIndex < eventCount())
     {
-        return eventTimestamps[currentEventIndex];
+        return eventTime(currentEventIndex);
     }
     return cursorTime;
 }
@@ -3065,12 +3483,6 @@ void WaveformWidget::insertSignalsAtCursor(const QList<VCDSignal> &newSignals, i
     if (cursorIndex < 0 || cursorIndex >= displayItems.size() || newSignals.isEmpty())
         return;
 
-    // Create display items for new signals
-    QList<DisplayItem> newItems;
-    for (const auto &signal : newSignals) {
-        newItems.append(DisplayItem::createSignal(signal));
-    }
-
     // Insert after the cursor position
     int insertPosition = cursorIndex + 1;
     
@@ -3079,18 +3491,24 @@ void WaveformWidget::insertSignalsAtCursor(const QList<VCDSignal> &newSignals, i
         insertPosition = displayItems.size();
     }
 
-    // Insert the new signals
-    for (int i = newItems.size() - 1; i >= 0; i--) {
-        displayItems.insert(insertPosition, newItems[i]);
+    // NEW: Splice the new rows in with one rebuild instead of one insert per
+    // signal, each of which shifted every row below the cursor
+    QList<DisplayItem> items;
+    items.reserve(displayItems.size() + newSignals.size());
+    items.append(displayItems.mid(0, insertPosition));
+    QList<QString> fullNames;
+    fullNames.reserve(newSignals.size());
+    for (const auto &signal : newSignals) {
+        items.append(DisplayItem::createSignal(signal));
+        fullNames.append(signal.fullName);
     }
+    items.append(displayItems.mid(insertPosition));
+    displayItems = std::move(items);
 
-    // Load signal data for the new signals
+    // Load signal data for the new signals in the background; rows show a
+    // placeholder until it arrives
     if (vcdParser) {
-        QList<QString> fullNames;
-        for (const auto &signal : newSignals) {
-            fullNames.append(signal.fullName);
-        }
-        vcdParser->loadSignalsData(fullNames);
+        vcdParser->loadSignalsDataAsync(fullNames);
     }
 
     // Clear selection and update
@@ -3098,7 +3516,7 @@ void WaveformWidget::insertSignalsAtCursor(const QList<VCDSignal> &newSignals, i
     lastSelectedItem = -1;
     
     // Move the cursor to below the newly inserted signals
-    signalCursorIndex = insertPosition + newItems.size() - 1;
+    signalCursorIndex = insertPosition + newSignals.size() - 1;
     showSignalCursor = true;
     
     updateScrollBar();
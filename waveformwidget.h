@@ -18,6 +18,7 @@
 #include <QColorDialog>
 
 #include "vcdparser.h"
+#include "signaldiff.h"
 
 // Simple signal display structure
 struct DisplaySignal
@@ -126,6 +127,10 @@ class WaveformWidget : public QWidget
 public:
     void highlightSignal(int signalIndex, bool highlight);
     void clearSearchHighlights();
+
+    // NEW: Mismatches from a comparison, drawn over the compared signal's row
+    void setMismatchOverlay(const QString &fullName, const QVector<SignalDiff::Interval> &mismatches);
+    void clearMismatchOverlays();
     void selectSignalByIndex(int index);
 
     // Signal cursor methods
@@ -182,10 +187,23 @@ public:
     explicit WaveformWidget(QWidget *parent = nullptr);
     void setVcdData(VCDParser *parser);
     void setVisibleSignals(const QList<VCDSignal> &visibleSignals);
+    void refreshTimeRange(); // NEW: end time grew (streamed dumps)
+
+    // NEW: Cycle view. The rising edges of a clock become the time base:
+    // every clock cycle gets the same width however long it lasts, so idle
+    // stretches shrink, and other signals show the value sampled at each
+    // edge. Times stay real times; only the axis changes. An empty name, or a
+    // clock without rising edges, goes back to plain time.
+    void setCycleClock(const QString &fullName);
+    QString getCycleClock() const { return cycleClock; }
+    bool isCycleView() const { return !clockEdges.isEmpty(); }
+    int cycleAtTime(int time) const; // Rising edges at or before 'time'
+    int cycleCount() const { return clockEdges.size(); }
     void zoomIn();
     void zoomOut();
     void zoomFit();
     void removeSelectedSignals();
+    void removeSignals(const QSet<QString> &fullNames); // NEW: Every row showing one of these
     void selectAllSignals();
     void resetSignalColors();
     void setBusDisplayFormat(BusFormat format);
@@ -203,6 +221,9 @@ signals:
     void contextMenuRequested(const QPoint &pos, int itemIndex);
     void cursorTimeChanged(int time); // ADD THIS - for yellow timeline cursor
 
+private slots:
+    void onSignalsDataLoaded(); // NEW: a background load finished
+
 protected:
     void paintEvent(QPaintEvent *event) override;
     void wheelEvent(QWheelEvent *event) override;
@@ -216,6 +237,8 @@ protected:
 
 private:
     QSet<int> highlightedSignals; // NEW: Track highlighted signals for search results
+    QHash<QString, QVector<SignalDiff::Interval>> mismatchOverlays; // By full name
+    void drawMismatchOverlay(QPainter &painter, const QVector<SignalDiff::Interval> &mismatches, int yPos);
 
     void drawSignalCursor(QPainter &painter);
     int signalCursorIndex = -1; // -1 means no cursor, otherwise index where cursor is placed
@@ -231,17 +254,22 @@ private:
 
         int availableWidth = width() - signalNamesWidth - valuesColumnWidth;
 
+        if (vcdParser->hasTimeWindow() && availableWidth > 10)
+        {
+            double windowRange = qMax(1.0, timeToAxis(vcdParser->getWindowEnd()) - timeToAxis(vcdParser->getWindowStart()));
+            return qMax(0.001, qMin(50.0, availableWidth / windowRange));
+        }
+
         // Use the same calculation as zoomFit but just return the scale
         const int PADDING = 10;
-        int totalTimeRange = vcdParser->getEndTime() + (2 * PADDING);
-        totalTimeRange = qMax(20, totalTimeRange);
+        double axisEnd = qMax(1.0, timeToAxis(vcdParser->getEndTime())); // NEW: cycles in cycle view
 
         if (availableWidth <= 10)
         {
             return 1.0;
         }
 
-        double zoomFitScale = static_cast<double>(availableWidth - (2 * PADDING)) / vcdParser->getEndTime();
+        double zoomFitScale = static_cast<double>(availableWidth - (2 * PADDING)) / axisEnd;
         return qMax(0.02, qMin(50.0, zoomFitScale));
     }
     void resetNavigationForCurrentSignal();
@@ -264,27 +292,48 @@ private:
     }
     int selectedLineWidth = 3;
 
-    // Navigation
-    QMap<QString, QVector<int>> signalEventTimestamps; // Maps signal fullName to its events
-    QMap<QString, int> signalCurrentEventIndex;        // Maps signal fullName to its current event index
-    QString currentlyNavigatedSignal;                  // Which signal we're currently navigating
+    // Navigation: edges of the navigated signal come from the parser's
+    // EdgeIndex, so next/previous are rank/select lookups, not list scans
+    QString currentlyNavigatedSignal;          // Which signal we're currently navigating
+    QVector<VCDValueChange> navigationChanges; // Its value changes (shared with the parser)
+    EdgeIndex navigationIndex;
     NavigationMode navigationMode = ValueChange;
-    int currentEventIndex = -1;
-    QVector<int> eventTimestamps;
+    int currentEventIndex = -1; // Event (edge) number, -1 before the first
 
+    // NEW: With several signals selected, next/previous step through the
+    // union of their events: a k-way merge keeps one cursor per signal in a
+    // heap, so a step costs O(log N) and the union is never built
+    struct NavigationTrack
+    {
+        QString fullName;
+        QVector<VCDValueChange> changes;
+        EdgeIndex index;
+    };
+    struct MergeCursor
+    {
+        int time;
+        int track;
+        int event;
+    };
+    QVector<NavigationTrack> navigationTracks; // Every selected signal, in row order
+    QVector<MergeCursor> mergeHeap;
+    int mergeDirection = 0; // +1 next, -1 previous, 0 not built
+    int mergeTime = 0;      // Cursor time the heap was built or stepped for
+
+    bool isMultiSignalNavigation() const { return navigationTracks.size() > 1; }
+    bool trackEventTime(const NavigationTrack &track, int event, int *time) const;
+    void buildMergeHeap(int direction);
+    void stepMergedEvent(int direction);
+    EdgeIndex::Kind navigationKind() const;
+    int eventCount() const { return navigationIndex.count(navigationKind()); }
+    int eventTime(int event) const;
     void updateEventList();
     int findEventIndexForTime(int time) const;
     int getCurrentEventTime() const;
 
     // Signal selection from waveform area
     void handleWaveformClick(const QPoint &pos);
-    // Track which signals have been loaded to avoid reloading
-    QSet<QString> loadedSignalIdentifiers;
-
-    // Signal data cache with limits
-    QMap<QString, QVector<VCDValueChange>> signalDataCache;
-    const int MAX_CACHED_SIGNALS = 1000; // Limit cache size
-    QStringList recentlyUsedSignals;     // For LRU cache management
+    // Loaded data lives in VCDParser and is evicted by SignalCache
 
     // Make sure these search methods exist:
     void handleSearchInput(const QString &text);
@@ -303,6 +352,20 @@ private:
     void drawTimeCursor(QPainter &painter);
     void drawGrid(QPainter &painter);
     void drawSignals(QPainter &painter);
+    void requestVisibleSignalData();
+    QVector<VCDValueChange> visibleValueChanges(const QString &fullName) const;
+
+    // Cycle view state: axis positions are CYCLE_AXIS_UNITS per cycle
+    static constexpr double CYCLE_AXIS_UNITS = 10.0;
+    QString cycleClock;
+    QVector<int> clockEdges; // Rising edge times, ascending
+    mutable QHash<QString, QVector<VCDValueChange>> cycleSamples; // Sampled changes by full name
+    void buildClockEdges();
+    double timeToAxis(int time) const;
+    int axisToTime(double axis) const;
+    int cycleStartTime(int cycle) const;
+    QVector<VCDValueChange> sampledValueChanges(const QString &fullName) const;
+    bool fitAfterLoad = false; // zoomFit once the first background load lands
     void drawSignalWaveform(QPainter &painter, const VCDSignal &signal, int yPos);
     void drawBusWaveform(QPainter &painter, const VCDSignal &signal, int yPos);
     void updateScrollBar();
@@ -310,7 +373,7 @@ private:
     int xToTime(int x) const;
     QString getSignalValueAtTime(const QString &identifier, int time) const;
     QString getBusValueAtTime(const QString &identifier, int time) const;
-    int calculateTimeStep(int startTime, int endTime) const;
+    int calculateTimeStep(int startTime, int endTime, double axisUnitsPerStep = 1.0) const;
     int getItemAtPosition(const QPoint &pos) const;
     int getItemYPosition(int index) const;
     void showContextMenu(const QPoint &pos, int itemIndex);